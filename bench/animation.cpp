@@ -0,0 +1,53 @@
+#include "bench.hpp"
+#include <engine/render/animation.hpp>
+#include <memory>
+#include <vector>
+
+// Animator throughput: options.count animated sprites sharing a few clips,
+// advanced once per frame.
+namespace Bench {
+namespace {
+void AnimatorUpdate(const Options &options, std::vector<Result> &out) {
+    std::shared_ptr<const Engine::AnimationClip> clips[] = {
+        Engine::AnimationClip::FromGrid("walk", Engine::Vector2(32, 32), 8, 8,
+                                        0.1f),
+        Engine::AnimationClip::FromGrid("idle", Engine::Vector2(32, 32), 4, 4,
+                                        0.25f, Engine::LoopMode::PingPong),
+        Engine::AnimationClip::FromGrid("attack", Engine::Vector2(32, 32), 6,
+                                        6, 0.05f, Engine::LoopMode::Once),
+    };
+
+    Engine::Animator animator;
+    std::vector<std::unique_ptr<Engine::AnimatedSprite>> sprites;
+    sprites.reserve(options.count);
+    for (int i = 0; i < options.count; i++) {
+        auto sprite =
+            std::make_unique<Engine::AnimatedSprite>(animator, nullptr);
+        sprite->SetSpeed(0.5f + (i % 7) * 0.25f);
+        sprite->Play(clips[i % 3]);
+        sprites.push_back(std::move(sprite));
+    }
+
+    constexpr float DT = 1.0f / 60.0f;
+    std::vector<double> samples;
+    samples.reserve(options.frames);
+    AllocCounters allocStart = GetAllocCounters();
+    for (int frame = 0; frame < options.frames; frame++) {
+        uint64_t start = NowNS();
+        animator.Update(DT);
+        samples.push_back((NowNS() - start) / 1e6);
+    }
+    AllocCounters allocEnd = GetAllocCounters();
+
+    Result result;
+    result.name = "animation/update";
+    result.Add("sprites", options.count);
+    result.Add("frames", options.frames);
+    AddTimings(result, "update", samples);
+    AddAllocations(result, allocStart, allocEnd, options.frames);
+    out.push_back(std::move(result));
+}
+} // namespace
+
+BENCH_CASE("animation/update", AnimatorUpdate);
+} // namespace Bench
@@ -0,0 +1,68 @@
+#include "bench.hpp"
+#include <cstddef>
+#include <engine/render/manager.hpp>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Per-frame temporaries: listing every layer's renderables each frame into
+// heap vectors versus a frame arena set up like Engine's.
+namespace Bench {
+namespace {
+constexpr int LAYERS[] = {Engine::Layers::BACKGROUND, Engine::Layers::WORLD,
+                          Engine::Layers::ENTITIES, Engine::Layers::UI};
+
+void Run(const char *name, bool arena, const Options &options,
+         std::vector<Result> &out) {
+    Engine::RenderManager rdrMgr;
+    for (int i = 0; i < options.count; i++) {
+        rdrMgr.Create<Engine::CircleShape>(
+            LAYERS[i % 4], Engine::Vector2(static_cast<float>(i), 0.0f), 4.0f,
+            Engine::Color::White());
+    }
+
+    constexpr size_t ARENA_SIZE = 1 << 20;
+    auto buffer = std::make_unique<std::byte[]>(ARENA_SIZE);
+    std::pmr::monotonic_buffer_resource frameArena(buffer.get(), ARENA_SIZE);
+
+    std::vector<double> samples;
+    samples.reserve(options.frames);
+    size_t visited = 0;
+    AllocCounters allocStart = GetAllocCounters();
+    for (int frame = 0; frame < options.frames; frame++) {
+        uint64_t start = NowNS();
+        frameArena.release();
+        for (int layer : LAYERS) {
+            if (arena) {
+                visited +=
+                    rdrMgr.GetRenderablesInLayer(layer, &frameArena).size();
+            } else {
+                visited += rdrMgr.GetRenderablesInLayer(layer).size();
+            }
+        }
+        samples.push_back((NowNS() - start) / 1e6);
+    }
+    AllocCounters allocEnd = GetAllocCounters();
+
+    Result result;
+    result.name = name;
+    result.Add("objects", options.count);
+    result.Add("frames", options.frames);
+    result.Add("visited_per_frame",
+               static_cast<double>(visited) / options.frames);
+    AddTimings(result, "list", samples);
+    AddAllocations(result, allocStart, allocEnd, options.frames);
+    out.push_back(std::move(result));
+}
+
+void Heap(const Options &options, std::vector<Result> &out) {
+    Run("arena/list_heap", false, options, out);
+}
+void Arena(const Options &options, std::vector<Result> &out) {
+    Run("arena/list_frame_arena", true, options, out);
+}
+} // namespace
+
+BENCH_CASE("arena/list_heap", Heap);
+BENCH_CASE("arena/list_frame_arena", Arena);
+} // namespace Bench
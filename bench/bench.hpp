@@ -0,0 +1,62 @@
+#ifndef _BENCH_HPP
+#define _BENCH_HPP
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+namespace Engine {
+class Engine;
+}
+namespace Bench {
+struct Options {
+    int frames = 300;
+    int count = 1000;
+    std::string filter;
+};
+
+// One benchmark's output, written as a flat JSON object.
+struct Result {
+    std::string name;
+    std::vector<std::pair<std::string, double>> metrics;
+
+    void Add(std::string key, double value) {
+        metrics.emplace_back(std::move(key), value);
+    }
+};
+
+using BenchFn = void (*)(const Options &options, std::vector<Result> &out);
+
+// Adds a benchmark to the list run by main(). Use through BENCH_CASE.
+struct Registration {
+    Registration(const char *name, BenchFn fn);
+};
+
+#define BENCH_CASE(name, fn)                                                   \
+    static const ::Bench::Registration s_bench_##fn(name, fn)
+
+// Allocation counters fed by the operator new replacement in main.cpp.
+struct AllocCounters {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+AllocCounters GetAllocCounters();
+
+uint64_t NowNS();
+
+// The engine singleton, initialised headless with a software renderer on
+// first use. nullptr when SDL fails to start.
+Engine::Engine *BootEngine();
+
+// Percentile of already sorted samples, nearest rank.
+double Percentile(const std::vector<double> &sorted, double p);
+
+// Adds mean/p50/p95/p99/max of the samples (in milliseconds) to result.
+void AddTimings(Result &result, const std::string &prefix,
+                std::vector<double> samples);
+
+// Adds allocs_per_frame and alloc_bytes_per_frame from counters read before
+// and after a loop of frames iterations.
+void AddAllocations(Result &result, const AllocCounters &start,
+                    const AllocCounters &end, int frames);
+} // namespace Bench
+#endif
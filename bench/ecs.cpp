@@ -0,0 +1,71 @@
+#include "bench.hpp"
+#include <engine/ecs/systems.hpp>
+
+// Gameplay simulation on the ECS without rendering: movement and grid
+// collision over N bouncing boxes, meant to be run with --count 100000.
+namespace Bench {
+namespace {
+constexpr float WORLD_SIZE = 4096.0f;
+
+void Simulate(const Options &options, std::vector<Result> &out) {
+    Engine::Ecs::Registry registry;
+    for (int i = 0; i < options.count; i++) {
+        int64_t n = i;
+        Engine::Ecs::Entity entity = registry.Create();
+        registry.Add<Engine::Ecs::Transform>(
+            entity,
+            Engine::Vector2(static_cast<float>((n * 7919) % 4096),
+                            static_cast<float>((n * 104729) % 4096)));
+        registry.Add<Engine::Ecs::Velocity>(
+            entity, Engine::Vector2(static_cast<float>(n % 61 - 30),
+                                    static_cast<float>(n % 47 - 23)));
+        registry.Add<Engine::Ecs::Collider>(
+            entity, Engine::Rect(-4.0f, -4.0f, 8.0f, 8.0f));
+    }
+    Engine::Ecs::CollisionSystem collisions(16.0f);
+    // one warm up step sizes the scratch buffers
+    collisions.Update(registry);
+
+    constexpr float DT = 1.0f / 60.0f;
+    std::vector<double> moveTimes, collideTimes;
+    moveTimes.reserve(options.frames);
+    collideTimes.reserve(options.frames);
+    size_t pairs = 0;
+    AllocCounters allocStart = GetAllocCounters();
+    for (int frame = 0; frame < options.frames; frame++) {
+        uint64_t start = NowNS();
+        Engine::Ecs::UpdateMovement(registry, DT);
+        // wrap around so the density stays constant
+        registry.Each<Engine::Ecs::Transform>(
+            [](Engine::Ecs::Entity, Engine::Ecs::Transform &transform) {
+                Engine::Vector2 &pos = transform.position;
+                pos.x = pos.x < 0.0f ? pos.x + WORLD_SIZE
+                        : pos.x >= WORLD_SIZE ? pos.x - WORLD_SIZE
+                                              : pos.x;
+                pos.y = pos.y < 0.0f ? pos.y + WORLD_SIZE
+                        : pos.y >= WORLD_SIZE ? pos.y - WORLD_SIZE
+                                              : pos.y;
+            });
+        uint64_t moved = NowNS();
+        collisions.Update(registry);
+        uint64_t end = NowNS();
+        moveTimes.push_back((moved - start) / 1e6);
+        collideTimes.push_back((end - moved) / 1e6);
+        pairs += collisions.GetPairs().size();
+    }
+    AllocCounters allocEnd = GetAllocCounters();
+
+    Result result;
+    result.name = "ecs/simulate";
+    result.Add("entities", options.count);
+    result.Add("frames", options.frames);
+    AddTimings(result, "move", moveTimes);
+    AddTimings(result, "collide", collideTimes);
+    result.Add("pairs_per_frame", static_cast<double>(pairs) / options.frames);
+    AddAllocations(result, allocStart, allocEnd, options.frames);
+    out.push_back(std::move(result));
+}
+} // namespace
+
+BENCH_CASE("ecs/simulate", Simulate);
+} // namespace Bench
@@ -0,0 +1,87 @@
+#include "bench.hpp"
+#include <algorithm>
+#include <memory>
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+// What the frame path pays for logging: a burst of messages per frame into a
+// file through the synchronous logger, the async logger, and a logger whose
+// level filters them out at runtime. Messages below SPDLOG_ACTIVE_LEVEL are
+// not measured, they compile to nothing.
+namespace Bench {
+namespace {
+enum class LogMode { Sync, Async, Filtered };
+
+constexpr size_t QUEUE_SIZE = 8192;
+constexpr const char *LOG_FILE = "logs/bench.log";
+
+void Run(const char *name, LogMode mode, const Options &options,
+         std::vector<Result> &out) {
+    int messages = std::max(1, options.count / 50);
+    spdlog::sink_ptr sinks[] = {
+        std::make_shared<spdlog::sinks::basic_file_sink_mt>(LOG_FILE, true)};
+
+    std::shared_ptr<spdlog::details::thread_pool> pool;
+    std::shared_ptr<spdlog::logger> logger;
+    if (mode == LogMode::Async) {
+        pool = std::make_shared<spdlog::details::thread_pool>(QUEUE_SIZE, 1);
+        logger = std::make_shared<spdlog::async_logger>(
+            name, sinks, sinks + 1, pool,
+            spdlog::async_overflow_policy::overrun_oldest);
+    } else {
+        logger = std::make_shared<spdlog::logger>(name, sinks, sinks + 1);
+    }
+    logger->set_pattern("[%^%l%$] [%Y-%m-%d %H:%M:%S.%e] %v");
+    logger->set_level(mode == LogMode::Filtered ? spdlog::level::warn
+                                                : spdlog::level::info);
+
+    std::vector<double> samples;
+    samples.reserve(options.frames);
+    AllocCounters allocStart = GetAllocCounters();
+    for (int frame = 0; frame < options.frames; frame++) {
+        uint64_t start = NowNS();
+        for (int i = 0; i < messages; i++) {
+            logger->info("Mouse moved to: ({:.0f}, {:.0f})",
+                         static_cast<float>(i), static_cast<float>(frame));
+        }
+        samples.push_back((NowNS() - start) / 1e6);
+    }
+    AllocCounters allocEnd = GetAllocCounters();
+    // outside the timed loop, this is where the async logger pays
+    logger->flush();
+
+    Result result;
+    result.name = name;
+    result.Add("messages_per_frame", messages);
+    result.Add("frames", options.frames);
+    AddTimings(result, "log", samples);
+    double total = 0.0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    result.Add("ns_per_message",
+               total * 1e6 / (static_cast<double>(messages) * options.frames));
+    AddAllocations(result, allocStart, allocEnd, options.frames);
+    if (pool) {
+        result.Add("overrun", static_cast<double>(pool->overrun_counter()));
+    }
+    out.push_back(std::move(result));
+}
+
+void Sync(const Options &options, std::vector<Result> &out) {
+    Run("logging/sync_file", LogMode::Sync, options, out);
+}
+void Async(const Options &options, std::vector<Result> &out) {
+    Run("logging/async_file", LogMode::Async, options, out);
+}
+void Filtered(const Options &options, std::vector<Result> &out) {
+    Run("logging/filtered", LogMode::Filtered, options, out);
+}
+} // namespace
+
+BENCH_CASE("logging/sync_file", Sync);
+BENCH_CASE("logging/async_file", Async);
+BENCH_CASE("logging/filtered", Filtered);
+} // namespace Bench
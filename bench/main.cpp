@@ -0,0 +1,158 @@
+#include "bench.hpp"
+#include <SDL3/SDL_timer.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <engine/util/memory.hpp>
+#include <new>
+#include <string_view>
+
+// Counting every allocation in the process is what makes the per-frame
+// allocation numbers possible, so the harness replaces the global operators.
+// With engine allocation tracking on, the engine's replacement counts them.
+#if !ENGINE_TRACK_ALLOCATIONS
+static std::atomic<uint64_t> s_allocCount{0};
+static std::atomic<uint64_t> s_allocBytes{0};
+
+void *operator new(std::size_t size) {
+    s_allocCount.fetch_add(1, std::memory_order_relaxed);
+    s_allocBytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+namespace Bench {
+namespace {
+struct Case {
+    const char *name;
+    BenchFn fn;
+};
+
+std::vector<Case> &Cases() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+void WriteJson(FILE *out, const std::vector<Result> &results) {
+    std::fprintf(out, "[\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &result = results[i];
+        std::fprintf(out, "  {\"name\": \"%s\"", result.name.c_str());
+        for (const auto &[key, value] : result.metrics) {
+            std::fprintf(out, ", \"%s\": %.6g", key.c_str(), value);
+        }
+        std::fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(out, "]\n");
+}
+} // namespace
+
+Registration::Registration(const char *name, BenchFn fn) {
+    Cases().push_back({name, fn});
+}
+
+AllocCounters GetAllocCounters() {
+#if ENGINE_TRACK_ALLOCATIONS
+    AllocCounters counters;
+    for (size_t i = 0; i < static_cast<size_t>(Engine::MemoryTag::Count); i++) {
+        Engine::MemoryStats stats =
+            Engine::Memory::GetTotalStats(static_cast<Engine::MemoryTag>(i));
+        counters.count += stats.allocations;
+        counters.bytes += stats.bytes;
+    }
+    return counters;
+#else
+    return {s_allocCount.load(std::memory_order_relaxed),
+            s_allocBytes.load(std::memory_order_relaxed)};
+#endif
+}
+
+uint64_t NowNS() { return SDL_GetTicksNS(); }
+
+double Percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(rank, sorted.size() - 1)];
+}
+
+void AddTimings(Result &result, const std::string &prefix,
+                std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    result.Add(prefix + "_mean_ms",
+               samples.empty() ? 0.0 : sum / samples.size());
+    result.Add(prefix + "_p50_ms", Percentile(samples, 50.0));
+    result.Add(prefix + "_p95_ms", Percentile(samples, 95.0));
+    result.Add(prefix + "_p99_ms", Percentile(samples, 99.0));
+    result.Add(prefix + "_max_ms", samples.empty() ? 0.0 : samples.back());
+}
+
+void AddAllocations(Result &result, const AllocCounters &start,
+                    const AllocCounters &end, int frames) {
+    result.Add("allocs_per_frame",
+               static_cast<double>(end.count - start.count) / frames);
+    result.Add("alloc_bytes_per_frame",
+               static_cast<double>(end.bytes - start.bytes) / frames);
+}
+} // namespace Bench
+
+// Usage: bench [--frames N] [--count N] [--filter substring] [--out file]
+//              [--list]
+int main(int argc, char *argv[]) {
+    Bench::Options options;
+    const char *outPath = nullptr;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--frames" && i + 1 < argc) {
+            options.frames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--count" && i + 1 < argc) {
+            options.count = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg == "--list") {
+            for (const Bench::Case &benchCase : Bench::Cases()) {
+                std::printf("%s\n", benchCase.name);
+            }
+            return 0;
+        } else {
+            std::fprintf(stderr, "unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    std::vector<Bench::Result> results;
+    for (const Bench::Case &benchCase : Bench::Cases()) {
+        if (!options.filter.empty() &&
+            std::string_view(benchCase.name).find(options.filter) ==
+                std::string_view::npos) {
+            continue;
+        }
+        std::fprintf(stderr, "running %s\n", benchCase.name);
+        benchCase.fn(options, results);
+    }
+
+    FILE *out = outPath ? std::fopen(outPath, "w") : stdout;
+    if (out == nullptr) {
+        std::fprintf(stderr, "could not open %s\n", outPath);
+        return 1;
+    }
+    Bench::WriteJson(out, results);
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "bench.hpp"
+#include <engine/render/layer.hpp>
+#include <engine/render/manager.hpp>
+#include <engine/render/renderable.hpp>
+#include <memory>
+#include <vector>
+
+// Spawn/despawn churn the way games do it: options.count circles added to a
+// layer and removed again with Layer::Remove every frame, spawned through
+// make_unique and AddRenderable versus RenderManager::Create's pool.
+namespace Bench {
+namespace {
+void Run(const char *name, bool pooled, const Options &options,
+         std::vector<Result> &out) {
+    Engine::RenderManager rdrMgr;
+    Engine::Layer &layer = rdrMgr.GetLayer(Engine::Layers::ENTITIES);
+    std::vector<Engine::Renderable *> live;
+    live.reserve(options.count);
+
+    std::vector<double> samples;
+    samples.reserve(options.frames);
+    AllocCounters allocStart = GetAllocCounters();
+    for (int frame = 0; frame < options.frames; frame++) {
+        uint64_t start = NowNS();
+        for (int i = 0; i < options.count; i++) {
+            Engine::Vector2 pos(static_cast<float>(i), 0.0f);
+            if (pooled) {
+                live.push_back(rdrMgr.Create<Engine::CircleShape>(
+                    Engine::Layers::ENTITIES, pos, 4.0f,
+                    Engine::Color::White()));
+            } else {
+                auto circle = std::make_unique<Engine::CircleShape>(
+                    pos, 4.0f, Engine::Color::White());
+                live.push_back(circle.get());
+                rdrMgr.AddRenderable(std::move(circle),
+                                     Engine::Layers::ENTITIES);
+            }
+        }
+        // despawn out of order like gameplay would
+        for (size_t i = 0; i < live.size(); i += 2) {
+            layer.Remove(live[i]);
+        }
+        for (size_t i = 1; i < live.size(); i += 2) {
+            layer.Remove(live[i]);
+        }
+        live.clear();
+        samples.push_back((NowNS() - start) / 1e6);
+    }
+    AllocCounters allocEnd = GetAllocCounters();
+
+    Result result;
+    result.name = name;
+    result.Add("objects", options.count);
+    result.Add("frames", options.frames);
+    AddTimings(result, "churn", samples);
+    AddAllocations(result, allocStart, allocEnd, options.frames);
+    out.push_back(std::move(result));
+}
+
+void MakeUnique(const Options &options, std::vector<Result> &out) {
+    Run("pool/churn_make_unique", false, options, out);
+}
+void Pooled(const Options &options, std::vector<Result> &out) {
+    Run("pool/churn_pool", true, options, out);
+}
+} // namespace
+
+BENCH_CASE("pool/churn_make_unique", MakeUnique);
+BENCH_CASE("pool/churn_pool", Pooled);
+} // namespace Bench
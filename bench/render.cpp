@@ -0,0 +1,468 @@
+#include "bench.hpp"
+#include <SDL3/SDL_render.h>
+#include <engine/core/texture.hpp>
+#include <engine/ecs/systems.hpp>
+#include <engine/engine.hpp>
+#include <memory>
+
+// Frame-time benchmarks: headless Engine, software renderer, N objects spread
+// over the built-in layers.
+namespace Bench {
+namespace {
+enum SceneFlags {
+    SPRITES = 1 << 0,
+    RECTANGLES = 1 << 1,
+    CIRCLES = 1 << 2,
+    LINES = 1 << 3,
+    ALL = SPRITES | RECTANGLES | CIRCLES | LINES,
+};
+
+constexpr int SCENE_LAYERS[] = {Engine::Layers::BACKGROUND,
+                                Engine::Layers::WORLD, Engine::Layers::ENTITIES,
+                                Engine::Layers::FOREGROUND, Engine::Layers::UI};
+constexpr int SCREEN_WIDTH = 1280;
+constexpr int SCREEN_HEIGHT = 720;
+} // namespace
+
+Engine::Engine *BootEngine() {
+    static bool booted = false;
+    Engine::Engine &engine = Engine::Engine::Instance();
+    if (!booted) {
+        Engine::Startup::Begin();
+        Engine::WindowProps props;
+        props.title = "bench";
+        props.width = SCREEN_WIDTH;
+        props.height = SCREEN_HEIGHT;
+        props.resizable = false;
+        props.headless = true;
+        if (!engine.Init(props)) {
+            std::fprintf(stderr, "engine init failed: %s\n", SDL_GetError());
+            return nullptr;
+        }
+        // an empty first frame, so startup/engine can report the time to it
+        engine.GetRenderer().Clear(Engine::Color::Black());
+        engine.GetRenderer().Present();
+        Engine::Startup::MarkFirstFrame();
+        booted = true;
+    }
+    return &engine;
+}
+
+namespace {
+// A 32x32 checkerboard so sprite benchmarks need no files on disk.
+std::shared_ptr<Engine::Texture> MakeTexture(Engine::Renderer &renderer) {
+    constexpr int SIZE = 32;
+    Uint32 pixels[SIZE * SIZE];
+    for (int y = 0; y < SIZE; y++) {
+        for (int x = 0; x < SIZE; x++) {
+            pixels[y * SIZE + x] =
+                ((x / 8 + y / 8) % 2) ? 0xFFFFFFFFu : 0xFF4080C0u;
+        }
+    }
+    SDL_Texture *sdlTex =
+        SDL_CreateTexture(renderer.GetSDLRenderer(), SDL_PIXELFORMAT_RGBA8888,
+                          SDL_TEXTUREACCESS_STATIC, SIZE, SIZE);
+    SDL_UpdateTexture(sdlTex, nullptr, pixels, SIZE * sizeof(Uint32));
+    auto texture = std::make_shared<Engine::Texture>();
+    texture->SetTexture(sdlTex);
+    return texture;
+}
+
+// Deterministic positions, no <random> so runs are comparable.
+Engine::Vector2 ScenePosition(int i) {
+    int64_t n = i;
+    return Engine::Vector2(static_cast<float>((n * 7919) % SCREEN_WIDTH),
+                           static_cast<float>((n * 104729) % SCREEN_HEIGHT));
+}
+
+void BuildScene(Engine::RenderManager &rdrMgr,
+                const std::shared_ptr<Engine::Texture> &texture, int count,
+                int flags) {
+    int kinds = 0;
+    for (int bit = SPRITES; bit <= LINES; bit <<= 1) {
+        kinds += (flags & bit) ? 1 : 0;
+    }
+    int placed = 0;
+    for (int i = 0; placed < count; i++) {
+        int kind = 1 << (i % 4);
+        if (!(flags & kind)) {
+            continue;
+        }
+        Engine::Vector2 pos = ScenePosition(placed);
+        Engine::Color color(static_cast<uint8_t>(placed * 37),
+                            static_cast<uint8_t>(placed * 91), 200);
+        std::unique_ptr<Engine::Renderable> renderable;
+        switch (kind) {
+        case SPRITES:
+            renderable = std::make_unique<Engine::Sprite>(texture, pos);
+            break;
+        case RECTANGLES:
+            renderable = std::make_unique<Engine::RectangleShape>(
+                Engine::Rect(pos.x, pos.y, 24.0f, 16.0f), color,
+                placed % 2 == 0);
+            break;
+        case CIRCLES:
+            renderable = std::make_unique<Engine::CircleShape>(
+                pos, 12.0f, color, placed % 2 == 0);
+            break;
+        case LINES:
+            renderable = std::make_unique<Engine::Line>(
+                pos, pos + Engine::Vector2(30.0f, 10.0f), color);
+            break;
+        }
+        renderable->SetRotation(static_cast<float>((placed * 13) % 360));
+        int layer = SCENE_LAYERS[(placed / kinds) % 5];
+        rdrMgr.AddRenderable(std::move(renderable), layer);
+        placed++;
+    }
+}
+
+void RunScene(const char *name, int flags, bool animate,
+              const Options &options, std::vector<Result> &out) {
+    Engine::Engine *engine = BootEngine();
+    if (engine == nullptr) {
+        return;
+    }
+    Engine::Renderer &renderer = engine->GetRenderer();
+    Engine::RenderManager &rdrMgr = engine->GetRenderManager();
+    std::shared_ptr<Engine::Texture> texture = MakeTexture(renderer);
+    BuildScene(rdrMgr, texture, options.count, flags);
+
+    std::vector<Engine::Renderable *> animated;
+    if (animate) {
+        for (int layer : SCENE_LAYERS) {
+            for (Engine::Renderable *r : rdrMgr.GetRenderablesInLayer(layer)) {
+                animated.push_back(r);
+            }
+        }
+    }
+
+    // warm up caches and lazily created SDL state before measuring
+    for (int i = 0; i < 10; i++) {
+        renderer.Clear(Engine::Color::Black());
+        rdrMgr.RenderAll(renderer);
+        renderer.Present();
+    }
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(options.frames);
+    uint64_t drawCalls = 0;
+    uint64_t commands = 0;
+    AllocCounters allocStart = GetAllocCounters();
+    for (int frame = 0; frame < options.frames; frame++) {
+        uint64_t start = NowNS();
+        for (Engine::Renderable *r : animated) {
+            r->Rotate(1.0f);
+        }
+        renderer.Clear(Engine::Color::Black());
+        rdrMgr.RenderAll(renderer);
+        renderer.Present();
+        frameTimes.push_back((NowNS() - start) / 1e6);
+        drawCalls += renderer.GetFrameStats().drawCalls;
+        commands += renderer.GetFrameStats().commands;
+    }
+    AllocCounters allocEnd = GetAllocCounters();
+
+    Result result;
+    result.name = name;
+    result.Add("objects", options.count);
+    result.Add("frames", options.frames);
+    AddTimings(result, "frame", frameTimes);
+    // draws recorded before merging, against the calls that reached SDL
+    result.Add("commands_per_frame",
+               static_cast<double>(commands) / options.frames);
+    result.Add("draw_calls_per_frame",
+               static_cast<double>(drawCalls) / options.frames);
+    AddAllocations(result, allocStart, allocEnd, options.frames);
+    out.push_back(std::move(result));
+
+    rdrMgr.Clear();
+}
+
+// One emitter holding options.count particles, kept full by its spawn rate.
+void ParticleScene(const Options &options, std::vector<Result> &out) {
+    Engine::Engine *engine = BootEngine();
+    if (engine == nullptr) {
+        return;
+    }
+    Engine::Renderer &renderer = engine->GetRenderer();
+    Engine::RenderManager &rdrMgr = engine->GetRenderManager();
+
+    Engine::EmitterProps props;
+    props.lifetimeMin = 1.0f;
+    props.lifetimeMax = 3.0f;
+    props.rate = options.count / 2.0f;
+    props.spread = 180.0f;
+    props.gravity = Engine::Vector2(0.0f, 60.0f);
+    auto emitter = std::make_unique<Engine::ParticleEmitter>(
+        options.count, MakeTexture(renderer), props);
+    emitter->SetPosition(Engine::Vector2(SCREEN_WIDTH / 2, SCREEN_HEIGHT / 2));
+    emitter->Emit(options.count);
+    Engine::ParticleEmitter *particles = emitter.get();
+    rdrMgr.AddRenderable(std::move(emitter), Engine::Layers::ENTITIES);
+
+    constexpr float DT = 1.0f / 60.0f;
+    for (int i = 0; i < 10; i++) {
+        particles->Update(DT);
+        renderer.Clear(Engine::Color::Black());
+        rdrMgr.RenderAll(renderer);
+        renderer.Present();
+    }
+
+    std::vector<double> updateTimes;
+    std::vector<double> frameTimes;
+    updateTimes.reserve(options.frames);
+    frameTimes.reserve(options.frames);
+    uint64_t drawCalls = 0;
+    uint64_t alive = 0;
+    AllocCounters allocStart = GetAllocCounters();
+    for (int frame = 0; frame < options.frames; frame++) {
+        uint64_t start = NowNS();
+        particles->Update(DT);
+        uint64_t updated = NowNS();
+        renderer.Clear(Engine::Color::Black());
+        rdrMgr.RenderAll(renderer);
+        renderer.Present();
+        uint64_t end = NowNS();
+        updateTimes.push_back((updated - start) / 1e6);
+        frameTimes.push_back((end - start) / 1e6);
+        drawCalls += renderer.GetFrameStats().drawCalls;
+        alive += particles->GetCount();
+    }
+    AllocCounters allocEnd = GetAllocCounters();
+
+    Result result;
+    result.name = "render/particles";
+    result.Add("capacity", options.count);
+    result.Add("frames", options.frames);
+    result.Add("alive_per_frame", static_cast<double>(alive) / options.frames);
+    AddTimings(result, "update", updateTimes);
+    AddTimings(result, "frame", frameTimes);
+    result.Add("draw_calls_per_frame",
+               static_cast<double>(drawCalls) / options.frames);
+    AddAllocations(result, allocStart, allocEnd, options.frames);
+    out.push_back(std::move(result));
+
+    rdrMgr.Clear();
+}
+
+// The mixed scene spread over a world four screens wide and high, with a
+// camera panning across it so most objects are culled. Split screen draws
+// two half-width views with cameras moving in opposite directions.
+void RunCameraScene(const char *name, bool splitScreen, const Options &options,
+                    std::vector<Result> &out) {
+    Engine::Engine *engine = BootEngine();
+    if (engine == nullptr) {
+        return;
+    }
+    Engine::Renderer &renderer = engine->GetRenderer();
+    Engine::RenderManager &rdrMgr = engine->GetRenderManager();
+    std::shared_ptr<Engine::Texture> texture = MakeTexture(renderer);
+    BuildScene(rdrMgr, texture, options.count, ALL);
+    for (int layer : SCENE_LAYERS) {
+        for (Engine::Renderable *r : rdrMgr.GetRenderablesInLayer(layer)) {
+            Engine::Vector2 pos = r->GetPosition();
+            r->SetPosition(Engine::Vector2(pos.x * 4.0f, pos.y * 4.0f));
+        }
+    }
+
+    Engine::Camera2D camera(Engine::Vector2(SCREEN_WIDTH, SCREEN_HEIGHT));
+    Engine::Camera2D second(Engine::Vector2(SCREEN_WIDTH / 2, SCREEN_HEIGHT));
+    if (splitScreen) {
+        camera.SetViewportSize(second.GetViewportSize());
+        Engine::RenderView left;
+        left.viewport = Engine::Rect(0, 0, SCREEN_WIDTH / 2, SCREEN_HEIGHT);
+        left.camera = &camera;
+        Engine::RenderView right = left;
+        right.viewport.x = SCREEN_WIDTH / 2;
+        right.camera = &second;
+        rdrMgr.AddView(left);
+        rdrMgr.AddView(right);
+    } else {
+        rdrMgr.SetCamera(&camera);
+    }
+    rdrMgr.GetLayer(Engine::Layers::BACKGROUND)
+        .SetParallax(Engine::Vector2(0.5f, 0.5f));
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(options.frames);
+    uint64_t drawCalls = 0;
+    for (int frame = 0; frame < options.frames; frame++) {
+        float t = static_cast<float>(frame) / options.frames;
+        camera.SetPosition(Engine::Vector2(SCREEN_WIDTH * (0.5f + 3.0f * t),
+                                           SCREEN_HEIGHT * (0.5f + 3.0f * t)));
+        second.SetPosition(Engine::Vector2(SCREEN_WIDTH * (3.5f - 3.0f * t),
+                                           SCREEN_HEIGHT * (0.5f + 3.0f * t)));
+        uint64_t start = NowNS();
+        renderer.Clear(Engine::Color::Black());
+        rdrMgr.RenderAll(renderer);
+        renderer.Present();
+        frameTimes.push_back((NowNS() - start) / 1e6);
+        drawCalls += renderer.GetFrameStats().drawCalls;
+    }
+
+    Result result;
+    result.name = name;
+    result.Add("objects", options.count);
+    result.Add("frames", options.frames);
+    AddTimings(result, "frame", frameTimes);
+    result.Add("draw_calls_per_frame",
+               static_cast<double>(drawCalls) / options.frames);
+    out.push_back(std::move(result));
+
+    rdrMgr.SetCamera(nullptr);
+    rdrMgr.ClearViews();
+    rdrMgr.Clear();
+}
+
+void CameraScene(const Options &options, std::vector<Result> &out) {
+    RunCameraScene("render/camera_scroll", false, options, out);
+}
+void SplitScreenScene(const Options &options, std::vector<Result> &out) {
+    RunCameraScene("render/split_screen", true, options, out);
+}
+
+// Damage tracking on the mixed scene with a single object moving, the case
+// of a mostly static UI.
+void DamageScene(const Options &options, std::vector<Result> &out) {
+    Engine::Engine *engine = BootEngine();
+    if (engine == nullptr) {
+        return;
+    }
+    Engine::Renderer &renderer = engine->GetRenderer();
+    Engine::RenderManager &rdrMgr = engine->GetRenderManager();
+    std::shared_ptr<Engine::Texture> texture = MakeTexture(renderer);
+    BuildScene(rdrMgr, texture, options.count, ALL);
+    auto cursor = std::make_unique<Engine::RectangleShape>(
+        Engine::Rect(0.0f, 0.0f, 16.0f, 16.0f), Engine::Color::White());
+    Engine::RectangleShape *moving = cursor.get();
+    rdrMgr.AddRenderable(std::move(cursor), Engine::Layers::UI);
+    rdrMgr.SetDamageTracking(true);
+    rdrMgr.RenderDamaged(renderer, Engine::Color::Black());
+    renderer.Present();
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(options.frames);
+    uint64_t drawCalls = 0;
+    int skipped = 0;
+    for (int frame = 0; frame < options.frames; frame++) {
+        // every fourth frame nothing changes
+        if (frame % 4 != 3) {
+            moving->SetPosition(ScenePosition(frame));
+        }
+        uint64_t start = NowNS();
+        if (rdrMgr.RenderDamaged(renderer, Engine::Color::Black())) {
+            renderer.Present();
+            drawCalls += renderer.GetFrameStats().drawCalls;
+        } else {
+            skipped++;
+        }
+        frameTimes.push_back((NowNS() - start) / 1e6);
+    }
+
+    Result result;
+    result.name = "render/damage_one_moving";
+    result.Add("objects", options.count);
+    result.Add("frames", options.frames);
+    result.Add("skipped_frames", skipped);
+    AddTimings(result, "frame", frameTimes);
+    result.Add("draw_calls_per_frame",
+               static_cast<double>(drawCalls) / options.frames);
+    out.push_back(std::move(result));
+
+    rdrMgr.SetDamageTracking(false);
+    rdrMgr.Clear();
+}
+
+// The mixed sprite, rectangle and circle scene as ECS entities drawn by the
+// RenderSystem bridge instead of Renderables.
+void EcsScene(const Options &options, std::vector<Result> &out) {
+    Engine::Engine *engine = BootEngine();
+    if (engine == nullptr) {
+        return;
+    }
+    Engine::Renderer &renderer = engine->GetRenderer();
+    std::shared_ptr<Engine::Texture> texture = MakeTexture(renderer);
+
+    Engine::Ecs::Registry registry;
+    for (int i = 0; i < options.count; i++) {
+        Engine::Ecs::Entity entity = registry.Create();
+        registry.Add<Engine::Ecs::Transform>(
+            entity, ScenePosition(i), static_cast<float>((i * 13) % 360));
+        registry.Add<Engine::Ecs::Velocity>(entity, Engine::Vector2(),
+                                            90.0f);
+        if (i % 3 == 0) {
+            registry.Add<Engine::Ecs::SpriteRef>(entity, texture);
+        } else {
+            registry.Add<Engine::Ecs::Shape>(
+                entity,
+                i % 3 == 1 ? Engine::Ecs::ShapeType::Rectangle
+                           : Engine::Ecs::ShapeType::Circle,
+                Engine::Vector2(16.0f, 16.0f), Engine::Color::Green());
+        }
+    }
+    Engine::Ecs::RenderSystem renderSystem;
+    for (int i = 0; i < 10; i++) {
+        renderer.Clear(Engine::Color::Black());
+        renderSystem.Render(registry, renderer);
+        renderer.Present();
+    }
+
+    std::vector<double> frameTimes;
+    frameTimes.reserve(options.frames);
+    uint64_t drawCalls = 0;
+    AllocCounters allocStart = GetAllocCounters();
+    for (int frame = 0; frame < options.frames; frame++) {
+        uint64_t start = NowNS();
+        Engine::Ecs::UpdateMovement(registry, 1.0f / 60.0f);
+        renderer.Clear(Engine::Color::Black());
+        renderSystem.Render(registry, renderer);
+        renderer.Present();
+        frameTimes.push_back((NowNS() - start) / 1e6);
+        drawCalls += renderer.GetFrameStats().drawCalls;
+    }
+    AllocCounters allocEnd = GetAllocCounters();
+
+    Result result;
+    result.name = "render/ecs_mixed_rotating";
+    result.Add("objects", options.count);
+    result.Add("frames", options.frames);
+    AddTimings(result, "frame", frameTimes);
+    result.Add("draw_calls_per_frame",
+               static_cast<double>(drawCalls) / options.frames);
+    AddAllocations(result, allocStart, allocEnd, options.frames);
+    out.push_back(std::move(result));
+}
+
+void SpriteScene(const Options &options, std::vector<Result> &out) {
+    RunScene("render/sprites", SPRITES, false, options, out);
+}
+void RectangleScene(const Options &options, std::vector<Result> &out) {
+    RunScene("render/rectangles", RECTANGLES, false, options, out);
+}
+void CircleScene(const Options &options, std::vector<Result> &out) {
+    RunScene("render/circles", CIRCLES, false, options, out);
+}
+void LineScene(const Options &options, std::vector<Result> &out) {
+    RunScene("render/lines", LINES, false, options, out);
+}
+void MixedScene(const Options &options, std::vector<Result> &out) {
+    RunScene("render/mixed", ALL, false, options, out);
+}
+void MixedAnimatedScene(const Options &options, std::vector<Result> &out) {
+    RunScene("render/mixed_rotating", ALL, true, options, out);
+}
+} // namespace
+
+BENCH_CASE("render/sprites", SpriteScene);
+BENCH_CASE("render/rectangles", RectangleScene);
+BENCH_CASE("render/circles", CircleScene);
+BENCH_CASE("render/lines", LineScene);
+BENCH_CASE("render/mixed", MixedScene);
+BENCH_CASE("render/mixed_rotating", MixedAnimatedScene);
+BENCH_CASE("render/particles", ParticleScene);
+BENCH_CASE("render/camera_scroll", CameraScene);
+BENCH_CASE("render/split_screen", SplitScreenScene);
+BENCH_CASE("render/damage_one_moving", DamageScene);
+BENCH_CASE("render/ecs_mixed_rotating", EcsScene);
+} // namespace Bench
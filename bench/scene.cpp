@@ -0,0 +1,115 @@
+#include "bench.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <engine/engine.hpp>
+#include <filesystem>
+#include <iterator>
+
+// Scene loading: options.count renderables of mixed types saved once, then
+// loaded and instantiated into a fresh RenderManager, binary against JSON.
+// Sprites carry no texture so image decoding stays out of the numbers.
+namespace Bench {
+namespace {
+// a load of 100k objects takes long enough that a few samples do
+constexpr int MAX_RUNS = 10;
+
+constexpr int SCENE_LAYERS[] = {Engine::Layers::BACKGROUND,
+                                Engine::Layers::WORLD, Engine::Layers::ENTITIES,
+                                Engine::Layers::FOREGROUND};
+
+bool SaveScene(const char *path, int count) {
+    Engine::RenderManager rdrMgr;
+    for (int i = 0; i < count; i++) {
+        int64_t n = i;
+        Engine::Vector2 pos(static_cast<float>((n * 7919) % 4096),
+                            static_cast<float>((n * 104729) % 4096));
+        Engine::Color color(static_cast<uint8_t>(n * 37),
+                            static_cast<uint8_t>(n * 91),
+                            static_cast<uint8_t>(n * 53));
+        int layer = SCENE_LAYERS[i % std::size(SCENE_LAYERS)];
+        Engine::Renderable *renderable = nullptr;
+        switch (i % 4) {
+        case 0: {
+            auto *sprite = rdrMgr.Create<Engine::Sprite>(layer, nullptr, pos);
+            sprite->SetSourceRect(Engine::Rect(0.0f, 0.0f, 16.0f, 16.0f));
+            renderable = sprite;
+            break;
+        }
+        case 1:
+            renderable = rdrMgr.Create<Engine::RectangleShape>(
+                layer, Engine::Rect(pos.x, pos.y, 12.0f, 8.0f), color);
+            break;
+        case 2:
+            renderable = rdrMgr.Create<Engine::CircleShape>(layer, pos, 6.0f,
+                                                            color, true);
+            break;
+        default:
+            renderable = rdrMgr.Create<Engine::Line>(
+                layer, pos, pos + Engine::Vector2(10.0f, 4.0f), color);
+            break;
+        }
+        renderable->SetRotation(static_cast<float>(i % 360));
+    }
+    Engine::Scene scene;
+    scene.Capture(rdrMgr);
+    return scene.Save(path);
+}
+
+void LoadScene(const char *name, const char *path, const Options &options,
+               std::vector<Result> &out) {
+    Engine::Engine *engine = BootEngine();
+    if (engine == nullptr) {
+        return;
+    }
+    if (!SaveScene(path, options.count)) {
+        std::fprintf(stderr, "%s: saving failed: %s\n", name, SDL_GetError());
+        return;
+    }
+
+    int runs = std::min(options.frames, MAX_RUNS);
+    std::vector<double> loadTimes, instantiateTimes, totalTimes;
+    for (int run = 0; run < runs; run++) {
+        Engine::Scene scene;
+        uint64_t start = NowNS();
+        if (!scene.Load(path)) {
+            std::fprintf(stderr, "%s: loading failed: %s\n", name,
+                         SDL_GetError());
+            return;
+        }
+        uint64_t loaded = NowNS();
+        // tearing the manager down is not part of the load
+        Engine::RenderManager rdrMgr;
+        scene.Instantiate(rdrMgr, engine->GetResources());
+        uint64_t end = NowNS();
+        loadTimes.push_back((loaded - start) / 1e6);
+        instantiateTimes.push_back((end - loaded) / 1e6);
+        totalTimes.push_back((end - start) / 1e6);
+    }
+
+    std::error_code error;
+    uintmax_t fileBytes = std::filesystem::file_size(path, error);
+    std::filesystem::remove(path, error);
+
+    Result result;
+    result.name = name;
+    result.Add("objects", options.count);
+    result.Add("runs", runs);
+    result.Add("file_bytes", static_cast<double>(fileBytes));
+    AddTimings(result, "read", loadTimes);
+    AddTimings(result, "instantiate", instantiateTimes);
+    AddTimings(result, "load", totalTimes);
+    out.push_back(std::move(result));
+}
+
+void LoadBinary(const Options &options, std::vector<Result> &out) {
+    LoadScene("scene/load_binary", "bench_scene.scene", options, out);
+}
+
+void LoadJson(const Options &options, std::vector<Result> &out) {
+    LoadScene("scene/load_json", "bench_scene.json", options, out);
+}
+} // namespace
+
+BENCH_CASE("scene/load_binary", LoadBinary);
+BENCH_CASE("scene/load_json", LoadJson);
+} // namespace Bench
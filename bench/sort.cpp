@@ -0,0 +1,67 @@
+#include "bench.hpp"
+#include <engine/render/layer.hpp>
+#include <engine/render/renderable.hpp>
+#include <vector>
+
+// Layer y sorting with options.count entities drifting up and down a little
+// every frame, so most of the order carries over, against the same layer
+// reshuffled every frame.
+namespace Bench {
+namespace {
+void Run(const char *name, bool shuffle, const Options &options,
+         std::vector<Result> &out) {
+    Engine::Layer layer(0);
+    layer.SetSortMode(Engine::SortMode::Y);
+    std::vector<Engine::Renderable *> entities;
+    entities.reserve(options.count);
+    for (int i = 0; i < options.count; i++) {
+        int64_t n = i;
+        Engine::Vector2 pos(static_cast<float>((n * 7919) % 4096),
+                            static_cast<float>((n * 104729) % 4096));
+        auto rect = std::make_unique<Engine::RectangleShape>(
+            Engine::Rect(pos.x, pos.y, 8.0f, 8.0f), Engine::Color::White());
+        entities.push_back(rect.get());
+        layer.Add(std::move(rect));
+    }
+    // the first sort starts from insertion order, not part of the numbers
+    layer.Sort();
+
+    std::vector<double> samples;
+    samples.reserve(options.frames);
+    uint32_t random = 12345;
+    for (int frame = 0; frame < options.frames; frame++) {
+        for (Engine::Renderable *entity : entities) {
+            random = random * 1664525u + 1013904223u;
+            float step = static_cast<float>(random >> 24) / 255.0f - 0.5f;
+            if (shuffle) {
+                entity->SetPosition(Engine::Vector2(
+                    entity->GetPosition().x, static_cast<float>(random >> 20)));
+            } else {
+                entity->Move(Engine::Vector2(0.0f, step * 2.0f));
+            }
+        }
+        uint64_t start = NowNS();
+        layer.Sort();
+        samples.push_back((NowNS() - start) / 1e6);
+    }
+
+    Result result;
+    result.name = name;
+    result.Add("objects", options.count);
+    result.Add("frames", options.frames);
+    AddTimings(result, "sort", std::move(samples));
+    out.push_back(std::move(result));
+}
+
+void Coherent(const Options &options, std::vector<Result> &out) {
+    Run("layer/sort_y_coherent", false, options, out);
+}
+
+void Shuffled(const Options &options, std::vector<Result> &out) {
+    Run("layer/sort_y_shuffled", true, options, out);
+}
+} // namespace
+
+BENCH_CASE("layer/sort_y_coherent", Coherent);
+BENCH_CASE("layer/sort_y_shuffled", Shuffled);
+} // namespace Bench
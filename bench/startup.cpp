@@ -0,0 +1,26 @@
+#include "bench.hpp"
+#include <engine/engine.hpp>
+
+// Engine startup as recorded by Engine::Startup when BootEngine first ran:
+// time to the first presented frame and the main thread steps before it.
+// The engine boots once per process, so this is a single sample.
+namespace Bench {
+namespace {
+void EngineStartup(const Options &options, std::vector<Result> &out) {
+    if (BootEngine() == nullptr) {
+        return;
+    }
+    Result result;
+    result.name = "startup/engine";
+    result.Add("first_frame_ms", Engine::Startup::GetTimeToFirstFrame());
+    for (const Engine::Startup::Step &step : Engine::Startup::GetSteps()) {
+        if (step.mainThread) {
+            result.Add(step.name + "_ms", step.durationMs);
+        }
+    }
+    out.push_back(std::move(result));
+}
+} // namespace
+
+BENCH_CASE("startup/engine", EngineStartup);
+} // namespace Bench
@@ -0,0 +1,121 @@
+#include "bench.hpp"
+#include <SDL3/SDL_stdinc.h>
+#include <engine/util/math.hpp>
+#include <engine/util/transform.hpp>
+#include <vector>
+
+// Point transform microbenchmarks: the per-shape scalar code the renderables
+// used to carry versus Transform2D and the batch kernel.
+namespace Bench {
+namespace {
+// Written through a volatile so the optimizer keeps every variant's work.
+volatile float s_sink = 0.0f;
+
+std::vector<Engine::Vector2> MakePoints(size_t count) {
+    std::vector<Engine::Vector2> points(count);
+    for (size_t i = 0; i < count; i++) {
+        points[i] = Engine::Vector2(static_cast<float>(i % 97) - 48.0f,
+                                    static_cast<float>(i % 89) - 44.0f);
+    }
+    return points;
+}
+
+// Rotation, scale and translation recomputed per point, like the old
+// TriangleShape::CalculateAbsoluteVertex.
+void ScalarTrig(const std::vector<Engine::Vector2> &in,
+                std::vector<Engine::Vector2> &out, float rotation) {
+    Engine::Vector2 position(320.0f, 240.0f);
+    Engine::Vector2 scale(1.5f, 0.75f);
+    for (size_t i = 0; i < in.size(); i++) {
+        float rad = rotation * (SDL_PI_F / 180.0f);
+        float cosTheta = SDL_cosf(rad);
+        float sinTheta = SDL_sinf(rad);
+        out[i] = Engine::Vector2(
+            position.x + (in[i].x * scale.x * cosTheta -
+                          in[i].y * scale.y * sinTheta),
+            position.y +
+                (in[i].x * scale.x * sinTheta + in[i].y * scale.y * cosTheta));
+    }
+}
+
+void Run(const char *name, int variant, const Options &options,
+         std::vector<Result> &out) {
+    // 64 points per object keeps the working set in cache like a real frame
+    size_t count = static_cast<size_t>(options.count) * 64;
+    std::vector<Engine::Vector2> in = MakePoints(count);
+    std::vector<Engine::Vector2> result(count);
+    std::vector<double> samples;
+    samples.reserve(options.frames);
+
+    for (int frame = 0; frame < options.frames; frame++) {
+        float rotation = static_cast<float>(frame % 360);
+        Engine::Transform2D transform = Engine::Transform2D::FromTRS(
+            Engine::Vector2(320.0f, 240.0f), rotation,
+            Engine::Vector2(1.5f, 0.75f));
+        uint64_t start = NowNS();
+        switch (variant) {
+        case 0:
+            ScalarTrig(in, result, rotation);
+            break;
+        case 1:
+            for (size_t i = 0; i < count; i++) {
+                result[i] = transform.Apply(in[i]);
+            }
+            break;
+        case 2:
+            Engine::TransformPoints(transform, in.data(), result.data(),
+                                    count);
+            break;
+        case 3:
+        case 4:
+            // one rotation per point, as when every object spins
+            for (size_t i = 0; i < count; i++) {
+                float degrees = rotation + in[i].x;
+                if (variant == 3) {
+                    Engine::SinCosDegrees(degrees, result[i].x, result[i].y);
+                } else {
+                    Engine::FastSinCosDegrees(degrees, result[i].x,
+                                              result[i].y);
+                }
+            }
+            break;
+        }
+        samples.push_back((NowNS() - start) / 1e6);
+        s_sink = s_sink + result[frame % count].x;
+    }
+
+    Result res;
+    res.name = name;
+    res.Add("points", static_cast<double>(count));
+    AddTimings(res, "pass", samples);
+    double total = 0.0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    res.Add("ns_per_point", total * 1e6 / (count * options.frames));
+    out.push_back(std::move(res));
+}
+
+void ScalarBench(const Options &options, std::vector<Result> &out) {
+    Run("transform/scalar_trig", 0, options, out);
+}
+void ApplyBench(const Options &options, std::vector<Result> &out) {
+    Run("transform/apply", 1, options, out);
+}
+void BatchBench(const Options &options, std::vector<Result> &out) {
+    Run("transform/batch", 2, options, out);
+}
+void SinCosBench(const Options &options, std::vector<Result> &out) {
+    Run("transform/sincos", 3, options, out);
+}
+void FastSinCosBench(const Options &options, std::vector<Result> &out) {
+    Run("transform/fast_sincos", 4, options, out);
+}
+} // namespace
+
+BENCH_CASE("transform/scalar_trig", ScalarBench);
+BENCH_CASE("transform/apply", ApplyBench);
+BENCH_CASE("transform/batch", BatchBench);
+BENCH_CASE("transform/sincos", SinCosBench);
+BENCH_CASE("transform/fast_sincos", FastSinCosBench);
+} // namespace Bench
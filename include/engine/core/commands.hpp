@@ -0,0 +1,117 @@
+#ifndef _COMMANDS_HPP
+#define _COMMANDS_HPP
+#include <SDL3/SDL_render.h>
+#include <cstdint>
+#include <engine/core/renderer.hpp>
+#include <engine/util/color.hpp>
+#include <engine/util/vec2.hpp>
+#include <vector>
+namespace Engine {
+enum class RenderCommandType : uint8_t {
+    Geometry, // triangles, filled rects and textures end up here too
+    Lines,    // one connected strip
+    Points,
+    Rects, // outlines
+    Text,  // the built in debug font
+};
+
+// One draw, in screen space with every transform already applied. Plain
+// data: the vertices, points, rects or text it draws are a span of the
+// list's arrays.
+struct RenderCommand {
+    // layer:16 blend:4 texture:12 depth:32, see RenderCommandList::BeginLayer
+    uint64_t key;
+    SDL_Texture *texture;
+    // span of the vertices, points or rects, text has its position here
+    uint32_t first;
+    uint32_t count;
+    // geometry: span of the indices, relative to first. text: offset of the
+    // string in the text.
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    // for everything but geometry, which carries vertex colors
+    Color color;
+    RenderCommandType type;
+    BlendMode blendMode;
+};
+
+// A frame's draws recorded by Renderer::BeginRecording instead of going to
+// SDL, sorted by key and then replayed by Renderer::Submit, which merges
+// neighbouring draws sharing a texture and blend mode into one call. A list
+// stays valid after it was submitted, so it can be kept to look at or
+// submit again later. Recording uses the Renderer's single transform and
+// blend state, so a renderer records into one list at a time, from the
+// thread that renders.
+class RenderCommandList {
+  public:
+    // Empties the list, keeping its capacity for the next frame
+    void Clear();
+
+    // Commands after this sort after everything recorded before. With
+    // reorder set the layer's commands may be grouped by blend mode and
+    // texture, for layers whose draw order within does not matter,
+    // otherwise they keep the order they were recorded in.
+    void BeginLayer(bool reorder);
+
+    // indices nullptr means every three vertices make a triangle
+    void AddGeometry(SDL_Texture *texture, BlendMode blendMode,
+                     const SDL_Vertex *vertices, int numVertices,
+                     const int *indices, int numIndices);
+    void AddLines(Color color, BlendMode blendMode, const SDL_FPoint *points,
+                  int count);
+    void AddPoints(Color color, BlendMode blendMode, const SDL_FPoint *points,
+                   int count);
+    void AddRects(Color color, BlendMode blendMode, const SDL_FRect *rects,
+                  int count);
+    void AddText(Color color, BlendMode blendMode, Vector2 pos,
+                 const char *text);
+
+    // Orders the commands by key with a stable radix sort. Lists recorded
+    // without reordering layers are sorted already and only checked.
+    void Sort();
+
+    size_t GetCommandCount() const { return m_commands.size(); }
+    const std::vector<RenderCommand> &GetCommands() const { return m_commands; }
+    // Command indices in draw order, valid after Sort
+    const std::vector<uint32_t> &GetOrder() const { return m_order; }
+    const std::vector<SDL_Vertex> &GetVertices() const { return m_vertices; }
+    const std::vector<int> &GetIndices() const { return m_indices; }
+    const std::vector<SDL_FPoint> &GetPoints() const { return m_points; }
+    const std::vector<SDL_FRect> &GetRects() const { return m_rects; }
+    // Zero terminated strings, text commands point at their first byte
+    const std::vector<char> &GetText() const { return m_text; }
+
+  private:
+    RenderCommand &Add(RenderCommandType type, SDL_Texture *texture,
+                       BlendMode blendMode, Color color);
+    uint64_t GetTextureId(SDL_Texture *texture);
+
+    std::vector<RenderCommand> m_commands;
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
+    std::vector<SDL_FPoint> m_points;
+    std::vector<SDL_FRect> m_rects;
+    std::vector<char> m_text;
+
+    uint64_t m_layer = 0;
+    bool m_reorder = false;
+    uint32_t m_depth = 0;
+    // Small ids for the key's texture bits, only filled for reordering. A
+    // fixed hash table allocated once, Clear only bumps the generation.
+    struct TextureSlot {
+        SDL_Texture *texture = nullptr;
+        uint32_t id = 0;
+        uint32_t generation = 0;
+    };
+    std::vector<TextureSlot> m_textureSlots;
+    uint32_t m_textureGeneration = 1;
+    uint32_t m_textureCount = 0;
+
+    std::vector<uint32_t> m_order;
+    // radix sort scratch
+    std::vector<uint64_t> m_sortKeys;
+    std::vector<uint64_t> m_sortKeysTemp;
+    std::vector<uint32_t> m_orderTemp;
+};
+} // namespace Engine
+#endif
@@ -1,8 +1,13 @@
 #ifndef _EVENT_HPP
 #define _EVENT_HPP
 #include <SDL3/SDL_events.h>
+#include <SDL3/SDL_iostream.h>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <string>
 #include <unordered_map>
+#include <vector>
 namespace Engine {
 enum class EventType {
     WindowResize,
@@ -13,6 +18,14 @@ enum class EventType {
     MouseButtonUp,
     MouseMove,
 };
+// How ProcessEvent delivers an event type to its callbacks.
+enum class CoalescePolicy {
+    // Callbacks fire once per SDL event, as soon as it is processed.
+    Immediate,
+    // Events are merged into one pending event and fired by
+    // DispatchCoalesced(), at most once per frame.
+    Coalesce,
+};
 struct EventData {
     struct Window {
         int width;
@@ -28,6 +41,9 @@ struct EventData {
     struct Mouse {
         float x;
         float y;
+        // relative motion, summed over all merged MouseMove events
+        float dx;
+        float dy;
         int button;
     };
 
@@ -38,6 +54,15 @@ struct EventData {
     };
 };
 using EventCallback = std::function<void(const EventData &)>;
+// Returning true consumes the event, lower priority callbacks are skipped.
+using ConsumingEventCallback = std::function<bool(const EventData &)>;
+// Identifies a single registered callback. Handles of removed callbacks go
+// stale and are rejected, so deregistering twice is harmless.
+struct CallbackHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+    bool IsValid() const { return generation != 0; }
+};
 class EventManager {
   public:
     EventManager() = default;
@@ -46,12 +71,97 @@ class EventManager {
     void Shutdown();
     bool ProcessEvent(SDL_Event *event);
 
-    void RegisterCallback(EventType eventType, EventCallback callback);
+    // Callbacks run in descending priority, equal priorities in registration
+    // order. Registering or removing from inside a callback is allowed and
+    // takes effect once the current dispatch has finished.
+    CallbackHandle RegisterCallback(EventType eventType, EventCallback callback,
+                                    int priority = 0);
+    CallbackHandle RegisterConsumingCallback(EventType eventType,
+                                             ConsumingEventCallback callback,
+                                             int priority = 0);
+    bool DeregisterCallback(CallbackHandle handle);
     bool DeregisterCallback(EventType eventType);
 
+    // Only WindowResize, MouseMove and MouseWheel can be coalesced, key and
+    // button events are always delivered immediately.
+    bool SetCoalescePolicy(EventType eventType, CoalescePolicy policy);
+    CoalescePolicy GetCoalescePolicy(EventType eventType) const;
+    // Fires the merged event of every coalesced type that received input
+    // since the last call.
+    void DispatchCoalesced();
+
+    // Starts a new frame: feeds replayed events that were recorded during the
+    // previous frame, then fires coalesced events. Call once per frame.
+    void Update();
+    uint64_t GetFrame() const { return m_frame; }
+
+    // Appends every event handled by ProcessEvent to a binary log, tagged with
+    // the frame it arrived in. StopRecording ends the log with the frame
+    // count, so a replay also runs the frames after the last event.
+    bool StartRecording(const std::string &path);
+    void StopRecording();
+    bool IsRecording() const { return m_recordStream != nullptr; }
+
+    // Plays back a log written by StartRecording from the current frame on.
+    // Live input passed to ProcessEvent is ignored while replaying.
+    bool StartReplay(const std::string &path);
+    void StopReplay();
+    bool IsReplaying() const { return m_replaying; }
+    // True once Update ran as many frames as the recording did
+    bool IsReplayFinished() const {
+        return m_replaying &&
+               m_frame >= m_replayStartFrame + m_replayFrameCount;
+    }
+
   private:
-    std::unordered_map<EventType, std::vector<EventCallback>> m_eventBindings;
+    struct PendingEvent {
+        bool pending = false;
+        EventData data;
+    };
+
+    struct CallbackSlot {
+        ConsumingEventCallback callback;
+        EventType type;
+        int priority = 0;
+        uint32_t generation = 1;
+        bool alive = false;
+    };
+
+    // deque so slots never move while one of their callbacks is running
+    std::deque<CallbackSlot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    // slots removed but possibly still referenced by m_eventBindings
+    std::vector<uint32_t> m_deadSlots;
+    // slots registered during a dispatch, bound after it finishes
+    std::vector<uint32_t> m_pendingSlots;
+    // slot indices per event type, sorted by descending priority
+    std::unordered_map<EventType, std::vector<uint32_t>> m_eventBindings;
+    int m_dispatchDepth = 0;
+
+    struct RecordedEvent {
+        uint64_t frame;
+        SDL_Event event;
+    };
+
+    uint64_t m_frame = 0;
+    SDL_IOStream *m_recordStream = nullptr;
+    uint64_t m_recordStartFrame = 0;
+    uint64_t m_lastRecordedFrame = 0;
+    bool m_replaying = false;
+    uint64_t m_replayStartFrame = 0;
+    size_t m_replayCursor = 0;
+    uint64_t m_replayFrameCount = 0;
+    std::vector<RecordedEvent> m_replayEvents;
+    std::unordered_map<EventType, CoalescePolicy> m_policies = {
+        {EventType::MouseMove, CoalescePolicy::Coalesce},
+        {EventType::MouseWheel, CoalescePolicy::Coalesce}};
+    std::unordered_map<EventType, PendingEvent> m_pending;
     void InvokeCallback(EventType eventType, const EventData &eventData);
+    void Dispatch(EventType eventType, const EventData &eventData);
+    bool HandleEvent(const SDL_Event &event);
+    void RecordEvent(const SDL_Event &event);
+    void Bind(uint32_t slotIndex);
+    void Compact();
 };
 } // namespace Engine
 #endif
@@ -0,0 +1,73 @@
+#ifndef _INPUT_HPP
+#define _INPUT_HPP
+#include <SDL3/SDL_keyboard.h>
+#include <SDL3/SDL_mouse.h>
+#include <bitset>
+#include <engine/core/event.hpp>
+#include <engine/util/vec2.hpp>
+namespace Engine {
+// Matches SDL_BUTTON_LEFT ... SDL_BUTTON_X2
+enum class MouseButton { Left = 1, Middle, Right, X1, X2 };
+// Keyboard and mouse state built from the events EventManager dispatches,
+// live or replayed, so a replay drives it exactly like the recording did.
+// Update() takes one snapshot per frame so the queries below are plain bit
+// tests, no callbacks involved.
+class InputHandler {
+  public:
+    explicit InputHandler(EventManager &events);
+    ~InputHandler();
+
+    InputHandler(const InputHandler &) = delete;
+    InputHandler &operator=(const InputHandler &) = delete;
+
+    // Call once per frame after EventManager::Update
+    void Update();
+
+    bool IsDown(SDL_Scancode key) const { return m_keys[key]; }
+    bool WasPressed(SDL_Scancode key) const {
+        return m_keys[key] && !m_prevKeys[key];
+    }
+    bool WasReleased(SDL_Scancode key) const {
+        return !m_keys[key] && m_prevKeys[key];
+    }
+
+    bool IsDown(MouseButton button) const {
+        return (m_buttons & ButtonMask(button)) != 0;
+    }
+    bool WasPressed(MouseButton button) const {
+        return (m_buttons & ~m_prevButtons & ButtonMask(button)) != 0;
+    }
+    bool WasReleased(MouseButton button) const {
+        return (~m_buttons & m_prevButtons & ButtonMask(button)) != 0;
+    }
+
+    Vector2 GetMousePosition() const { return m_mousePosition; }
+    Vector2 GetMouseDelta() const {
+        return m_mousePosition - m_prevMousePosition;
+    }
+
+  private:
+    static SDL_MouseButtonFlags ButtonMask(MouseButton button) {
+        return SDL_BUTTON_MASK(static_cast<int>(button));
+    }
+
+    void OnKey(const EventData &data, bool down);
+    void OnButton(const EventData &data, bool down);
+
+    EventManager &m_events;
+    CallbackHandle m_callbacks[5];
+
+    // written by the callbacks, copied into the snapshot by Update
+    std::bitset<SDL_SCANCODE_COUNT> m_nextKeys;
+    SDL_MouseButtonFlags m_nextButtons = 0;
+    Vector2 m_nextMousePosition = Vector2(0.0f, 0.0f);
+
+    std::bitset<SDL_SCANCODE_COUNT> m_keys;
+    std::bitset<SDL_SCANCODE_COUNT> m_prevKeys;
+    SDL_MouseButtonFlags m_buttons = 0;
+    SDL_MouseButtonFlags m_prevButtons = 0;
+    Vector2 m_mousePosition = Vector2(0.0f, 0.0f);
+    Vector2 m_prevMousePosition = Vector2(0.0f, 0.0f);
+};
+} // namespace Engine
+#endif
@@ -4,11 +4,20 @@
 #include <engine/core/window.hpp>
 #include <engine/util/color.hpp>
 #include <engine/util/rect.hpp>
+#include <engine/util/transform.hpp>
 #include <engine/util/vec2.hpp>
 #include <vector>
 namespace Engine {
-enum class BlendMode { None, Blend, Add, Multiply };
+class RenderCommandList;
+enum class BlendMode : uint8_t { None, Blend, Add, Multiply };
 enum class RenderFlip { None, Horizontal, Vertical };
+// Counters for one presented frame.
+struct RenderStats {
+    uint32_t drawCalls = 0;
+    uint32_t vertices = 0;
+    // draws submitted through command lists, before merging
+    uint32_t commands = 0;
+};
 class Renderer {
   public:
     Renderer() = default;
@@ -22,8 +31,31 @@ class Renderer {
 
     void DrawPoint(Vector2 pos);
     void DrawLine(Vector2 pos1, Vector2 pos2);
+    // Connected line strip in a single draw call
+    void DrawLines(const SDL_FPoint *points, int count);
     void DrawRect(Rect rect);
     void FillRect(Rect rect);
+    void DrawGeometry(SDL_Texture *texture, const SDL_Vertex *vertices,
+                      int numVertices, const int *indices, int numIndices);
+    void DrawTextureRotated(SDL_Texture *texture, const SDL_FRect *srcRect,
+                            const SDL_FRect *dstRect, double angle,
+                            const SDL_FPoint *center, SDL_FlipMode flip);
+    // nullptr for both rects copies the whole texture over the whole target
+    void DrawTexture(SDL_Texture *texture, const SDL_FRect *srcRect,
+                     const SDL_FRect *dstRect);
+    // Built in 8x8 bitmap font, drawn with the current draw color
+    void DrawDebugText(Vector2 pos, const char *text);
+
+    // Until EndRecording, draws are added to commands instead of going to
+    // SDL, with the draw color and blend mode they would have used.
+    // Transforms work as usual, viewport, clip and target changes are not
+    // recorded and apply to the submission instead.
+    void BeginRecording(RenderCommandList *commands);
+    void EndRecording() { m_recording = nullptr; }
+    RenderCommandList *GetRecording() const { return m_recording; }
+    // Draws a sorted list, each run of geometry with the same texture and
+    // blend mode, or of points or rects with the same color, in one call.
+    void Submit(const RenderCommandList &commands);
 
     void SetDrawColor(Color color);
     Color GetDrawColor() const { return m_drawColor; }
@@ -34,8 +66,30 @@ class Renderer {
     void PushBlendMode(BlendMode mode);
     void PopBlendMode();
 
+    // Parent transform applied to everything drawn by renderables, layers
+    // push theirs while rendering their children.
+    void PushTransform(const Transform2D &transform);
+    void PopTransform();
+    const Transform2D &GetTransform() const { return m_transform; }
+    // Base of the transform stack, normally a camera's view. Only takes
+    // effect while nothing is pushed.
+    void SetViewTransform(const Transform2D &view);
+    const Transform2D &GetViewTransform() const { return m_viewTransform; }
+
     void SetViewport(Rect rect);
     void ResetViewport();
+    // nullptr disables clipping
+    void SetClipRect(const Rect *rect);
+    // nullptr renders to the window again
+    void SetTarget(SDL_Texture *texture);
+
+    // Offscreen texture the size of the output that keeps its contents
+    // between frames, for partial redraws. recreated is set when it was
+    // (re)created this call and holds nothing yet.
+    SDL_Texture *GetRetainedTarget(bool &recreated);
+
+    // Stats of the last frame passed to Present()
+    const RenderStats &GetFrameStats() const { return m_frameStats; }
 
     SDL_Renderer *GetSDLRenderer() const { return m_renderer; }
 
@@ -46,6 +100,24 @@ class Renderer {
     BlendMode m_currentBlendMode = BlendMode::Blend;
     float m_opacity = 1.0f;
     std::vector<BlendMode> m_blendModeStack;
+    Transform2D m_viewTransform;
+    Transform2D m_transform;
+    std::vector<Transform2D> m_transformStack;
+    SDL_Texture *m_retainedTarget = nullptr;
+    int m_retainedWidth = 0;
+    int m_retainedHeight = 0;
+    RenderStats m_stats;
+    RenderStats m_frameStats;
+
+    RenderCommandList *m_recording = nullptr;
+    void RecordTexture(SDL_Texture *texture, const SDL_FRect *srcRect,
+                       const SDL_FRect *dstRect, double angle,
+                       const SDL_FPoint *center, SDL_FlipMode flip);
+    // Submit's merged runs
+    std::vector<SDL_Vertex> m_batchVertices;
+    std::vector<int> m_batchIndices;
+    std::vector<SDL_FPoint> m_batchPoints;
+    std::vector<SDL_FRect> m_batchRects;
 };
 } // namespace Engine
 #endif
@@ -1,10 +1,16 @@
 #ifndef RESOURCE_HPP
 #define RESOURCE_HPP
 #include <engine/core/renderer.hpp>
+#include <cstddef>
 #include <engine/core/texture.hpp>
+#include <future>
 #include <memory>
+#include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <vector>
+struct SDL_Surface;
 namespace Engine {
 // add more resource types later (font, audio)
 enum class ResourceType { Texture };
@@ -18,12 +24,30 @@ class ResourceManager {
 
     std::shared_ptr<Texture> FindTexture(const std::string_view path);
 
+    // Reads an asset manifest, a JSON object whose "textures" array lists
+    // image paths. Only touches the file system, so it is safe on any
+    // thread. On failure error says why.
+    static bool ReadManifest(std::string_view path,
+                             std::vector<std::string> &textures,
+                             std::string *error = nullptr);
+    // Registers the textures and decodes them on worker threads. FindTexture
+    // then only uploads the decoded pixels, waiting for the decode if it is
+    // still running.
+    void Prefetch(const std::vector<std::string> &paths);
+
+    // Summed GetMemoryBytes of every cached texture
+    size_t GetTextureMemory() const;
+    size_t GetTextureCount() const { return m_textureMap.size(); }
+
   private:
     void CreateTexture(const std::string_view path);
 
     Renderer &m_renderer;
     std::unordered_map<std::string, ResourceType> m_resourcePaths;
     std::unordered_map<std::string_view, std::shared_ptr<Texture>> m_textureMap;
+    // decoded by the prefetch workers, taken by CreateTexture
+    std::unordered_map<std::string, std::future<SDL_Surface *>> m_prefetched;
+    std::vector<std::thread> m_prefetchWorkers;
 };
 } // namespace Engine
 #endif
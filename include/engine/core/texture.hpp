@@ -1,7 +1,11 @@
 #ifndef _TEXTURE_HPP
 #define _TEXTURE_HPP
+#include <cstddef>
 #include <engine/core/renderer.hpp>
+#include <string>
+#include <string_view>
 namespace Engine {
+class ResourceManager;
 class Texture {
   public:
     Texture() = default;
@@ -10,11 +14,24 @@ class Texture {
     SDL_Texture *GetSDLTexture() const { return m_texture; }
     int GetWidth() const { return m_width; }
     int GetHeight() const { return m_height; }
+    SDL_PixelFormat GetFormat() const { return m_format; }
+    // Pixel storage from size and format, what the GPU copy roughly costs
+    size_t GetMemoryBytes() const;
+    // File the texture was loaded from, empty when created in code. Scenes
+    // save it as the texture reference.
+    const std::string &GetPath() const { return m_path; }
 
   private:
+    // ResourceManager's cache is keyed on a view of m_path, so only it may
+    // set the path, once, before the texture goes into the cache
+    friend class ResourceManager;
+    void SetPath(std::string_view path) { m_path = path; }
+
     SDL_Texture *m_texture = nullptr;
     int m_width = 0;
     int m_height = 0;
+    SDL_PixelFormat m_format = SDL_PIXELFORMAT_UNKNOWN;
+    std::string m_path;
 };
 } // namespace Engine
 #endif
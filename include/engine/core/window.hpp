@@ -11,6 +11,8 @@ struct WindowProps {
     bool resizable = true;
     bool fullscreen = false;
     bool hdpi = false;
+    // Uses SDL's offscreen video driver, no display server required.
+    bool headless = false;
 };
 class Window {
   public:
@@ -27,12 +29,14 @@ class Window {
     SDL_Window *GetSDLWindow() const { return m_window; }
     uint16_t GetWidth() const { return m_width; }
     uint16_t GetHeight() const { return m_height; }
+    bool IsHeadless() const { return m_headless; }
 
   private:
     SDL_Window *m_window = nullptr;
     SDL_PropertiesID m_properties = 0;
     uint16_t m_width = 0;
     uint16_t m_height = 0;
+    bool m_headless = false;
     std::string m_title;
 };
 } // namespace Engine
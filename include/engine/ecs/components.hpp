@@ -0,0 +1,56 @@
+#ifndef _ECS_COMPONENTS_HPP
+#define _ECS_COMPONENTS_HPP
+#include <cstdint>
+#include <engine/util/color.hpp>
+#include <engine/util/rect.hpp>
+#include <engine/util/vec2.hpp>
+#include <memory>
+namespace Engine {
+class Texture;
+namespace Ecs {
+// Built-in components for gameplay entities. They are plain aggregates so
+// Registry::Add can brace initialise them and the sets can pack them.
+
+// position is the entity's centre, rotation in degrees
+struct Transform {
+    Vector2 position = Vector2(0.0f, 0.0f);
+    float rotation = 0.0f;
+    Vector2 scale = Vector2(1.0f, 1.0f);
+};
+
+// Units and degrees per second, applied by UpdateMovement
+struct Velocity {
+    Vector2 linear = Vector2(0.0f, 0.0f);
+    float angular = 0.0f;
+};
+
+// Textured quad centred on the Transform. An empty source draws the whole
+// texture, size defaults to the source's size.
+struct SpriteRef {
+    std::shared_ptr<Texture> texture;
+    Rect source = Rect();
+    Vector2 size = Vector2(0.0f, 0.0f);
+    Color tint = Color::White();
+};
+
+enum class ShapeType : uint8_t { Rectangle, Circle };
+
+// Filled shape centred on the Transform. Rectangles use size as width and
+// height, circles use size.x as the radius.
+struct Shape {
+    ShapeType type = ShapeType::Rectangle;
+    Vector2 size = Vector2(0.0f, 0.0f);
+    Color color = Color::White();
+};
+
+// Axis aligned box relative to the Transform's position, rotation and scale
+// are ignored. An entity only collides with others whose layer is in its
+// mask.
+struct Collider {
+    Rect bounds = Rect();
+    uint32_t layer = 1;
+    uint32_t mask = UINT32_MAX;
+};
+} // namespace Ecs
+} // namespace Engine
+#endif
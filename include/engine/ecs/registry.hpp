@@ -0,0 +1,197 @@
+#ifndef _ECS_REGISTRY_HPP
+#define _ECS_REGISTRY_HPP
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+namespace Engine {
+namespace Ecs {
+// An entity is only an id, everything about it lives in its components.
+// generation tells a destroyed entity apart from a new one reusing its index.
+struct Entity {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+    bool IsValid() const { return generation != 0; }
+
+    bool operator==(const Entity &other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const Entity &other) const { return !(*this == other); }
+};
+
+// Type-erased interface so the registry can strip a destroyed entity of
+// every component type.
+class ComponentSetBase {
+  public:
+    virtual ~ComponentSetBase() = default;
+    virtual void Remove(uint32_t entity) = 0;
+    virtual void Clear() = 0;
+};
+
+// Sparse set: components are packed in m_dense, m_sparse maps an entity
+// index to its component's position. Add, remove and lookup are O(1) and
+// iterating touches only live components. Removing moves the last component
+// into the hole, so pointers and positions are not stable across removals.
+template <typename T> class ComponentSet : public ComponentSetBase {
+  public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    // Replaces the component when the entity already has one
+    template <typename... Args> T &Emplace(uint32_t entity, Args &&...args) {
+        if (entity >= m_sparse.size()) {
+            m_sparse.resize(entity + 1, NONE);
+        }
+        uint32_t &slot = m_sparse[entity];
+        if (slot != NONE) {
+            m_dense[slot] = T{std::forward<Args>(args)...};
+            return m_dense[slot];
+        }
+        slot = static_cast<uint32_t>(m_dense.size());
+        m_dense.push_back(T{std::forward<Args>(args)...});
+        m_entities.push_back(entity);
+        return m_dense.back();
+    }
+
+    void Remove(uint32_t entity) override {
+        if (!Has(entity)) {
+            return;
+        }
+        uint32_t slot = m_sparse[entity];
+        uint32_t last = static_cast<uint32_t>(m_dense.size() - 1);
+        if (slot != last) {
+            m_dense[slot] = std::move(m_dense[last]);
+            m_entities[slot] = m_entities[last];
+            m_sparse[m_entities[slot]] = slot;
+        }
+        m_dense.pop_back();
+        m_entities.pop_back();
+        m_sparse[entity] = NONE;
+    }
+
+    void Clear() override {
+        m_dense.clear();
+        m_entities.clear();
+        m_sparse.clear();
+    }
+
+    bool Has(uint32_t entity) const {
+        return entity < m_sparse.size() && m_sparse[entity] != NONE;
+    }
+    T *Find(uint32_t entity) {
+        return Has(entity) ? &m_dense[m_sparse[entity]] : nullptr;
+    }
+    const T *Find(uint32_t entity) const {
+        return Has(entity) ? &m_dense[m_sparse[entity]] : nullptr;
+    }
+    // Find for an entity known to have the component
+    T &At(uint32_t entity) { return m_dense[m_sparse[entity]]; }
+
+    size_t Size() const { return m_dense.size(); }
+    // Packed components and the entity index owning each one
+    T *Data() { return m_dense.data(); }
+    const T *Data() const { return m_dense.data(); }
+    const uint32_t *Entities() const { return m_entities.data(); }
+
+  private:
+    std::vector<T> m_dense;
+    std::vector<uint32_t> m_entities;
+    std::vector<uint32_t> m_sparse;
+};
+
+// Owns entities and one ComponentSet per component type. Components are
+// plain structs, any type can be one.
+class Registry {
+  public:
+    Registry() = default;
+
+    Registry(const Registry &) = delete;
+    Registry &operator=(const Registry &) = delete;
+
+    Entity Create();
+    // Removes all of the entity's components, no-op for a dead entity
+    void Destroy(Entity entity);
+    bool IsAlive(Entity entity) const {
+        return entity.index < m_generations.size() &&
+               m_generations[entity.index] == entity.generation;
+    }
+    size_t GetEntityCount() const { return m_aliveCount; }
+    // Destroys every entity, keeps the capacity
+    void Clear();
+
+    // Aggregate initialises T from args, replacing an existing T. nullptr
+    // for a dead entity, whose index may be handed out again, so a stale
+    // handle cannot leave a component behind for the next entity there.
+    template <typename T, typename... Args>
+    T *Add(Entity entity, Args &&...args) {
+        assert(IsAlive(entity) && "Add on a destroyed entity");
+        if (!IsAlive(entity)) {
+            return nullptr;
+        }
+        return &GetSet<T>().Emplace(entity.index, std::forward<Args>(args)...);
+    }
+    template <typename T> void Remove(Entity entity) {
+        if (IsAlive(entity)) {
+            GetSet<T>().Remove(entity.index);
+        }
+    }
+    // nullptr when the entity is dead or has no T
+    template <typename T> T *Get(Entity entity) {
+        return IsAlive(entity) ? GetSet<T>().Find(entity.index) : nullptr;
+    }
+    template <typename T> bool Has(Entity entity) {
+        return IsAlive(entity) && GetSet<T>().Has(entity.index);
+    }
+
+    template <typename T> ComponentSet<T> &GetSet() {
+        std::unique_ptr<ComponentSetBase> &set =
+            m_sets[std::type_index(typeid(T))];
+        if (!set) {
+            set = std::make_unique<ComponentSet<T>>();
+        }
+        return static_cast<ComponentSet<T> &>(*set);
+    }
+
+    // Calls fn(entity, first, rest...) for every entity that has all the
+    // components, walking the first component's packed array in order. Put
+    // the rarest component first. fn must not add or remove components of
+    // the queried types.
+    template <typename First, typename... Rest, typename Fn>
+    void Each(Fn &&fn) {
+        ComponentSet<First> &first = GetSet<First>();
+        auto others = std::forward_as_tuple(GetSet<Rest>()...);
+        First *components = first.Data();
+        const uint32_t *entities = first.Entities();
+        size_t count = first.Size();
+        for (size_t i = 0; i < count; i++) {
+            uint32_t index = entities[i];
+            if (!std::apply(
+                    [index](auto &...sets) { return (sets.Has(index) && ...); },
+                    others)) {
+                continue;
+            }
+            Entity entity{index, m_generations[index]};
+            std::apply(
+                [&](auto &...sets) {
+                    fn(entity, components[i], sets.At(index)...);
+                },
+                others);
+        }
+    }
+
+  private:
+    // per entity index, the generation of the live entity or of the next one
+    std::vector<uint32_t> m_generations;
+    std::vector<uint32_t> m_freeIndices;
+    size_t m_aliveCount = 0;
+    std::unordered_map<std::type_index, std::unique_ptr<ComponentSetBase>>
+        m_sets;
+};
+} // namespace Ecs
+} // namespace Engine
+#endif
@@ -0,0 +1,70 @@
+#ifndef _ECS_SYSTEMS_HPP
+#define _ECS_SYSTEMS_HPP
+#include <SDL3/SDL_render.h>
+#include <cstdint>
+#include <engine/ecs/components.hpp>
+#include <engine/ecs/registry.hpp>
+#include <vector>
+namespace Engine {
+class Renderer;
+namespace Ecs {
+// Integrates every Velocity into its entity's Transform
+void UpdateMovement(Registry &registry, float dt);
+
+struct CollisionPair {
+    Entity a;
+    Entity b;
+};
+
+// Finds overlapping Colliders. Boxes are binned into a uniform grid and only
+// boxes sharing a cell are tested, each pair is reported once. Scratch
+// buffers are kept, so updates stop allocating once they reach the entity
+// count. cellSize works best around the size of a typical collider.
+class CollisionSystem {
+  public:
+    explicit CollisionSystem(float cellSize = 64.0f) : m_cellSize(cellSize) {}
+
+    void Update(Registry &registry);
+    // From the last Update
+    const std::vector<CollisionPair> &GetPairs() const { return m_pairs; }
+
+    void SetCellSize(float cellSize) { m_cellSize = cellSize; }
+    float GetCellSize() const { return m_cellSize; }
+
+  private:
+    struct Box {
+        Entity entity;
+        Rect bounds;
+        uint32_t layer;
+        uint32_t mask;
+        int32_t minX, minY, maxX, maxY;
+    };
+    struct CellEntry {
+        uint64_t cell;
+        uint32_t box;
+    };
+
+    float m_cellSize;
+    std::vector<Box> m_boxes;
+    std::vector<CellEntry> m_entries;
+    std::vector<CollisionPair> m_pairs;
+};
+
+// Bridge from the registry to the Renderer: draws Shape and SpriteRef
+// entities with the renderer's current transform. All shapes go out in one
+// geometry call, sprites in one per run of entities sharing a texture.
+class RenderSystem {
+  public:
+    RenderSystem();
+
+    void Render(Registry &registry, Renderer &renderer);
+
+  private:
+    void Flush(Renderer &renderer, SDL_Texture *texture);
+
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
+};
+} // namespace Ecs
+} // namespace Engine
+#endif
@@ -1,36 +1,68 @@
 #ifndef _ENGINE_HPP
 #define _ENGINE_HPP
 #include <engine/core/event.hpp>
+#include <engine/core/input.hpp>
 #include <engine/core/renderer.hpp>
 #include <engine/core/resource.hpp>
 #include <engine/core/window.hpp>
+#include <engine/ecs/systems.hpp>
+#include <engine/render/animation.hpp>
+#include <engine/render/debug.hpp>
 #include <engine/render/manager.hpp>
+#include <engine/render/particles.hpp>
 #include <engine/render/renderable.hpp>
+#include <engine/scene/scene.hpp>
+#include <engine/util/memory.hpp>
+#include <engine/util/startup.hpp>
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
+#include <string_view>
 namespace Engine {
 class Window;
 class Renderer;
 class EventManager;
 class RenderManager;
+class InputHandler;
+class DebugDraw;
+class Animator;
 // TODO: Later implementation
-// class InputHandler;
 // class AudioSystem;
 // class ResourceManager;
 // class Time;
 class Engine {
   public:
     static Engine &Instance();
-    bool Init();
+    // With a manifest path, the manifest is read while the window and
+    // renderer are created and its textures are decoded in the background
+    // from then on, see ResourceManager::Prefetch.
+    bool Init(const WindowProps &windowProps = WindowProps(),
+              std::string_view manifestPath = {});
     void Shutdown();
 
     Window &GetWindow();
     Renderer &GetRenderer();
     EventManager &GetEvents();
     RenderManager &GetRenderManager();
-    // InputHandler &GetInputs();
+    InputHandler &GetInputs();
+    DebugDraw &GetDebugDraw();
+    Animator &GetAnimator();
     // AudioSystem &GetAudio();
     ResourceManager &GetResources();
     // Time &GetTime();
+
+    // Bump allocator for game data that only lives until the end of the
+    // frame, reset by BeginFrame. Usable with any std::pmr container. The
+    // engine itself does not use it, so its buffer is only allocated by the
+    // first call.
+    std::pmr::memory_resource *GetFrameAllocator();
+    // Bytes the frame arena starts with, going past it falls back to the
+    // heap until the next reset
+    static constexpr size_t FRAME_ARENA_SIZE = 1 << 20;
+    // Releases everything allocated from the frame arena and starts a new
+    // frame of allocation stats, call once at the start of each frame
+    void BeginFrame();
+
   private:
     Engine() = default;
     ~Engine();
@@ -41,12 +73,17 @@ class Engine {
     std::unique_ptr<Window> m_window;
     std::unique_ptr<Renderer> m_renderer;
     std::unique_ptr<EventManager> m_eventHandler;
+    // declared first so it outlives the AnimatedSprites owned by layers
+    std::unique_ptr<Animator> m_animator;
     std::unique_ptr<RenderManager> m_renderManager;
     std::unique_ptr<ResourceManager> m_resManager;
+    std::unique_ptr<InputHandler> m_inputHandler;
+    std::unique_ptr<DebugDraw> m_debugDraw;
+    std::unique_ptr<std::byte[]> m_frameBuffer;
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> m_frameArena;
     // from main.cpp here as well
 
     // TODO: Later implementation
-    // std::unique_ptr<InputHandler> m_inputHandler;
     // std::unique_ptr<AudioSystem> m_audioSystem;
     // std::unique_ptr<Time> m_time;
 
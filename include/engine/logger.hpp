@@ -2,63 +2,134 @@
 #define LOGGING_HPP
 
 #include <chrono>
+#include <cstdio>
 #include <iomanip>
 #include <iostream>
-#include <spdlog/sinks/basic_file_sink.h>
-#include <spdlog/sinks/stdout_color_sinks.h>
+#include <mutex>
+#include <spdlog/async.h>
+#include <spdlog/details/file_helper.h>
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/spdlog.h>
+#include <sstream>
+#include <string>
+#include <vector>
 
 namespace Engine {
-class Logging {
-  public:
-    static void Init(const std::string &logFile = "logs/log.log",
-                     const bool additional_log = true) {
-        std::shared_ptr<spdlog::sinks::basic_file_sink_mt> file_sink;
-        try {
-            file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(
-                logFile, true);
-            file_sink->set_level(spdlog::level::trace);
-        } catch (const spdlog::spdlog_ex &ex) {
-            std::cerr << "Failed to create primary log file (file may be "
-                         "locked or inaccessible): "
-                      << ex.what() << std::endl;
+// Async logging formats on the calling thread and hands the message to a
+// background thread through a bounded queue, so a log call on the frame path
+// never waits for the disk.
+struct AsyncLogOptions {
+    // messages the queue holds before the overflow policy applies
+    size_t queueSize = 8192;
+    // block waits for room, overrun_oldest replaces the oldest queued message
+    // and discard_new drops the one being logged
+    spdlog::async_overflow_policy overflowPolicy =
+        spdlog::async_overflow_policy::overrun_oldest;
+    // how often buffered file output is flushed from the background
+    std::chrono::seconds flushInterval = std::chrono::seconds(1);
+};
 
-            auto console_sink =
-                std::make_shared<spdlog::sinks::stdout_color_sink_mt>();
-            auto logger = std::make_shared<spdlog::logger>("console_logger",
-                                                           console_sink);
+// File sink that opens its file on the first message rather than when it is
+// created. Behind an async logger the first message is written by the
+// logging thread, so startup never waits on creating log files. If the file
+// cannot be opened, messages go to stderr instead.
+template <typename Mutex>
+class LazyFileSink : public spdlog::sinks::base_sink<Mutex> {
+  public:
+    LazyFileSink(std::string path, bool truncate)
+        : m_path(std::move(path)), m_truncate(truncate) {}
 
-            spdlog::set_default_logger(logger);
-            spdlog::warn("Logging to console instead of file due to file lock "
-                         "or access issues.");
-            return;
+  protected:
+    void sink_it_(const spdlog::details::log_msg &msg) override {
+        spdlog::memory_buf_t formatted;
+        this->formatter_->format(msg, formatted);
+        if (Open()) {
+            m_file.write(formatted);
+        } else {
+            std::fwrite(formatted.data(), 1, formatted.size(), stderr);
         }
-        std::vector<spdlog::sink_ptr> sinks{file_sink};
+    }
+    void flush_() override {
+        if (m_opened) {
+            m_file.flush();
+        }
+    }
 
-        if (additional_log) {
+  private:
+    bool Open() {
+        if (!m_tried) {
+            m_tried = true;
             try {
-                auto current_time = std::chrono::system_clock::to_time_t(
-                    std::chrono::system_clock::now());
-                auto time = std::localtime(&current_time);
-                std::stringstream ss;
-                ss << std::put_time(time, "%Y_%m_%d_%H_%M_%S");
-                auto add_sink =
-                    std::make_shared<spdlog::sinks::basic_file_sink_mt>(
-                        "logs/" + ss.str() + ".log");
-                sinks.push_back(add_sink);
+                m_file.open(m_path, m_truncate);
+                m_opened = true;
             } catch (const spdlog::spdlog_ex &ex) {
-                std::cerr << "Failed to create additional log file: "
-                          << ex.what() << std::endl; // file perms issue
+                std::cerr << "Failed to create log file " << m_path
+                          << " (file may be locked or inaccessible), logging "
+                             "to stderr: "
+                          << ex.what() << std::endl;
             }
         }
+        return m_opened;
+    }
+
+    std::string m_path;
+    bool m_truncate;
+    bool m_tried = false;
+    bool m_opened = false;
+    spdlog::details::file_helper m_file;
+};
+using LazyFileSinkMt = LazyFileSink<std::mutex>;
+
+class Logging {
+  public:
+    static void Init(const std::string &logFile = "logs/log.log",
+                     const bool additional_log = true, const bool async = true,
+                     const AsyncLogOptions &asyncOptions = AsyncLogOptions()) {
+        if (async) {
+            spdlog::init_thread_pool(asyncOptions.queueSize, 1);
+        }
+
+        auto file_sink = std::make_shared<LazyFileSinkMt>(logFile, true);
+        file_sink->set_level(spdlog::level::trace);
+        std::vector<spdlog::sink_ptr> sinks{file_sink};
+
+        if (additional_log) {
+            auto current_time = std::chrono::system_clock::to_time_t(
+                std::chrono::system_clock::now());
+            auto time = std::localtime(&current_time);
+            std::stringstream ss;
+            ss << std::put_time(time, "%Y_%m_%d_%H_%M_%S");
+            sinks.push_back(
+                std::make_shared<LazyFileSinkMt>("logs/" + ss.str() + ".log",
+                                                 false));
+        }
 
-        auto logger = std::make_shared<spdlog::logger>(
-            "multi_sink", sinks.begin(), sinks.end());
-        spdlog::set_default_logger(logger);
+        spdlog::set_default_logger(
+            CreateLogger("multi_sink", sinks.begin(), sinks.end(), async,
+                         asyncOptions.overflowPolicy));
 
         spdlog::set_pattern("[%^%l%$] [%Y-%m-%d %H:%M:%S.%e] [%@] %v");
         spdlog::set_level(spdlog::level::info);
         spdlog::flush_on(spdlog::level::warn);
+        if (async) {
+            spdlog::flush_every(asyncOptions.flushInterval);
+        }
+    }
+
+    // Drains the async queue and stops the background threads, call before
+    // exiting so the last messages reach the file
+    static void Shutdown() { spdlog::shutdown(); }
+
+  private:
+    template <typename It>
+    static std::shared_ptr<spdlog::logger>
+    CreateLogger(const std::string &name, It begin, It end, const bool async,
+                 spdlog::async_overflow_policy overflowPolicy) {
+        if (async) {
+            return std::make_shared<spdlog::async_logger>(
+                name, begin, end, spdlog::thread_pool(), overflowPolicy);
+        }
+        return std::make_shared<spdlog::logger>(name, begin, end);
     }
 };
 } // namespace Engine
@@ -0,0 +1,123 @@
+#ifndef _ANIMATION_HPP
+#define _ANIMATION_HPP
+#include <cstdint>
+#include <engine/render/renderable.hpp>
+#include <engine/util/rect.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+namespace Engine {
+enum class LoopMode { Once, Loop, PingPong };
+
+struct AnimationFrame {
+    Rect source;
+    // seconds
+    float duration = 0.1f;
+};
+
+// Flipbook definition, immutable once built and shared by every sprite
+// playing it.
+class AnimationClip {
+  public:
+    AnimationClip(std::string_view name, std::vector<AnimationFrame> frames,
+                  LoopMode loopMode = LoopMode::Loop);
+
+    // Frames laid out left to right, top to bottom on a sprite sheet
+    static std::shared_ptr<const AnimationClip>
+    FromGrid(std::string_view name, Vector2 frameSize, int columns,
+             int frameCount, float frameDuration,
+             LoopMode loopMode = LoopMode::Loop, Vector2 origin = Vector2());
+
+    const std::string &GetName() const { return m_name; }
+    const std::vector<AnimationFrame> &GetFrames() const { return m_frames; }
+    int GetFrameCount() const { return static_cast<int>(m_frames.size()); }
+    LoopMode GetLoopMode() const { return m_loopMode; }
+    float GetDuration() const { return m_duration; }
+
+  private:
+    std::string m_name;
+    std::vector<AnimationFrame> m_frames;
+    LoopMode m_loopMode;
+    float m_duration = 0.0f;
+};
+
+struct AnimationHandle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+    bool IsValid() const { return generation != 0; }
+};
+
+// Advances every playing animation in one pass over a packed array and
+// writes the current frame into its sprite's source rect when it changes.
+// The engine owns one, AnimatedSprite registers with it.
+class Animator {
+  public:
+    AnimationHandle Add(Sprite *sprite);
+    void Remove(AnimationHandle handle);
+
+    void Play(AnimationHandle handle,
+              std::shared_ptr<const AnimationClip> clip, bool restart = true);
+    void Stop(AnimationHandle handle);
+    void SetPaused(AnimationHandle handle, bool paused);
+    void SetSpeed(AnimationHandle handle, float speed);
+
+    bool IsPlaying(AnimationHandle handle) const;
+    int GetFrame(AnimationHandle handle) const;
+
+    void Update(float dt);
+
+    size_t GetCount() const { return m_states.size(); }
+
+  private:
+    struct State {
+        Sprite *sprite = nullptr;
+        const AnimationClip *clip = nullptr;
+        float time = 0.0f;
+        float speed = 1.0f;
+        int frame = 0;
+        int direction = 1;
+        bool playing = false;
+        uint32_t slot = 0;
+    };
+    struct Slot {
+        uint32_t state = 0;
+        uint32_t generation = 1;
+    };
+
+    State *Find(AnimationHandle handle);
+    const State *Find(AnimationHandle handle) const;
+    void Advance(State &state, float dt);
+
+    // packed, iterated by Update, handles point at it through m_slots
+    std::vector<State> m_states;
+    // keeps each state's clip alive, parallel to m_states
+    std::vector<std::shared_ptr<const AnimationClip>> m_clips;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+};
+
+// Sprite whose source rect is driven by an Animator.
+class AnimatedSprite : public Sprite {
+  public:
+    AnimatedSprite(Animator &animator, std::shared_ptr<Texture> texture,
+                   Vector2 pos = Vector2(0.0f, 0.0f));
+    ~AnimatedSprite() override;
+
+    AnimatedSprite(const AnimatedSprite &) = delete;
+    AnimatedSprite &operator=(const AnimatedSprite &) = delete;
+
+    void Play(std::shared_ptr<const AnimationClip> clip, bool restart = true);
+    void Stop() { m_animator->Stop(m_handle); }
+    void SetPaused(bool paused) { m_animator->SetPaused(m_handle, paused); }
+    void SetSpeed(float speed) { m_animator->SetSpeed(m_handle, speed); }
+
+    bool IsPlaying() const { return m_animator->IsPlaying(m_handle); }
+    int GetFrame() const { return m_animator->GetFrame(m_handle); }
+
+  private:
+    Animator *m_animator;
+    AnimationHandle m_handle;
+};
+} // namespace Engine
+#endif
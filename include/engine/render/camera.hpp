@@ -0,0 +1,46 @@
+#ifndef _CAMERA_HPP
+#define _CAMERA_HPP
+#include <engine/util/rect.hpp>
+#include <engine/util/transform.hpp>
+#include <engine/util/vec2.hpp>
+namespace Engine {
+// 2D camera looking at m_position, which ends up in the centre of the
+// viewport. Zoom scales and rotation turns the world around that point.
+// RenderManager applies it as the renderer's base transform, so moving the
+// camera touches no renderables.
+class Camera2D {
+  public:
+    Camera2D() = default;
+    explicit Camera2D(Vector2 viewportSize) { m_viewportSize = viewportSize; }
+
+    void SetPosition(Vector2 pos) { m_position = pos; }
+    Vector2 GetPosition() const { return m_position; }
+    void Move(Vector2 delta) { m_position = m_position + delta; }
+
+    void SetZoom(float zoom) { m_zoom = zoom; }
+    float GetZoom() const { return m_zoom; }
+
+    void SetRotation(float degrees) { m_rotation = degrees; }
+    float GetRotation() const { return m_rotation; }
+
+    void SetViewportSize(Vector2 size) { m_viewportSize = size; }
+    Vector2 GetViewportSize() const { return m_viewportSize; }
+
+    // World to screen. parallax scales how far the camera's position moves
+    // the layer: 1 for the world, below 1 for distant backgrounds.
+    Transform2D GetViewTransform(Vector2 parallax = Vector2(1.0f, 1.0f)) const;
+
+    // World space bounds of everything the camera can see
+    Rect GetWorldBounds() const;
+
+    Vector2 WorldToScreen(Vector2 world) const;
+    Vector2 ScreenToWorld(Vector2 screen) const;
+
+  private:
+    Vector2 m_position = Vector2(0.0f, 0.0f);
+    float m_zoom = 1.0f;
+    float m_rotation = 0.0f;
+    Vector2 m_viewportSize = Vector2(0.0f, 0.0f);
+};
+} // namespace Engine
+#endif
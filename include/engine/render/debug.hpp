@@ -0,0 +1,80 @@
+#ifndef _DEBUG_HPP
+#define _DEBUG_HPP
+#include <SDL3/SDL_render.h>
+#include <cstddef>
+#include <engine/util/color.hpp>
+#include <engine/util/rect.hpp>
+#include <engine/util/vec2.hpp>
+#include <string_view>
+#include <vector>
+
+// Set for the engine and its users by CMake, see GAME_ENGINE_DEBUG_DRAW. It
+// changes DebugDraw's layout, so it must not differ between translation
+// units and is deliberately not derived from NDEBUG here.
+#ifndef ENGINE_ENABLE_DEBUG_DRAW
+#define ENGINE_ENABLE_DEBUG_DRAW 1
+#endif
+
+namespace Engine {
+class Renderer;
+// Immediate mode debug shapes in screen space. Calls are recorded into a
+// fixed size arena and drawn by Flush(), which the main loop calls once after
+// RenderAll. Commands that do not fit in the arena are dropped.
+class DebugDraw {
+  public:
+    static constexpr size_t DEFAULT_ARENA_SIZE = 64 * 1024;
+
+    explicit DebugDraw(size_t arenaSize = DEFAULT_ARENA_SIZE);
+
+#if ENGINE_ENABLE_DEBUG_DRAW
+    void Line(Vector2 start, Vector2 end, Color color);
+    void Rect(const ::Engine::Rect &rect, Color color, bool filled = false);
+    void Circle(Vector2 center, float radius, Color color);
+    void Text(Vector2 pos, std::string_view text, Color color);
+
+    // Draws everything recorded this frame and resets the arena
+    void Flush(Renderer &renderer);
+    void Clear();
+
+    size_t GetUsedBytes() const { return m_used; }
+    size_t GetDroppedCount() const { return m_dropped; }
+#else
+    void Line(Vector2, Vector2, Color) {}
+    void Rect(const ::Engine::Rect &, Color, bool = false) {}
+    void Circle(Vector2, float, Color) {}
+    void Text(Vector2, std::string_view, Color) {}
+
+    void Flush(Renderer &) {}
+    void Clear() {}
+
+    size_t GetUsedBytes() const { return 0; }
+    size_t GetDroppedCount() const { return 0; }
+#endif
+
+  private:
+#if ENGINE_ENABLE_DEBUG_DRAW
+    enum class CommandType : uint8_t { Line, Rect, FillRect, Circle, Text };
+    // Fixed header, text commands are followed by their null terminated
+    // string.
+    struct Command {
+        CommandType type;
+        uint32_t textLength;
+        Color color;
+        float a, b, c, d;
+    };
+
+    static size_t CommandSize(const Command &command);
+    Command *Push(CommandType type, Color color, size_t extra = 0);
+    void PushSegment(Vector2 start, Vector2 end, SDL_FColor color);
+    void PushQuad(const SDL_FPoint (&corners)[4], SDL_FColor color);
+
+    std::vector<unsigned char> m_arena;
+    size_t m_used = 0;
+    size_t m_dropped = 0;
+    // reused between flushes so steady state frames do not allocate
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
+#endif
+};
+} // namespace Engine
+#endif
@@ -1,22 +1,34 @@
 #ifndef _LAYER_HPP
 #define _LAYER_HPP
 #include <algorithm>
+#include <cstdint>
 #include <engine/core/renderer.hpp>
+#include <engine/render/renderable.hpp>
 #include <engine/util/vec2.hpp>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
 namespace Engine {
-class Renderable;
-enum class BlendMode;
+enum class BlendMode : uint8_t;
+// How a layer orders its renderables before drawing. Equal keys keep the
+// order the renderables were added in.
+enum class SortMode {
+    None,         // insertion order
+    Z,            // by GetZ
+    Y,            // by position y, then z, for top-down views
+    TextureThenZ, // grouped by draw texture, by z within a group
+};
 class Layer {
   public:
     Layer(int layerId, std::string_view name = "");
     ~Layer();
+    Layer(Layer &&) = default;
+    Layer &operator=(Layer &&) = default;
 
-    void Add(std::unique_ptr<Renderable> renderable);
+    void Add(RenderablePtr renderable);
     Renderable *Find(std::string_view name) const;
     bool Remove(Renderable *renderable);
     bool Remove(std::string_view name);
@@ -24,22 +36,66 @@ class Layer {
 
     void SetLayerName(std::string_view name) { m_name = std::string(name); }
 
-    void SetLayerPosition(Vector2 pos) { m_position = pos; };
-    void SetLayerRotation(float angle) { m_rotation = angle; };
-    void SetLayerScale(Vector2 scale) { m_scale = scale; };
-    void DeltaLayerPosition(Vector2 pos) { m_position = m_position + pos; };
-    void DeltaLayerRotation(float angle) { m_rotation += angle; };
-    void DeltaLayerScale(Vector2 scale) { m_scale = m_scale + scale; };
+    void SetLayerPosition(Vector2 pos) {
+        m_position = pos;
+        m_dirty = true;
+    }
+    void SetLayerRotation(float angle) {
+        m_rotation = angle;
+        m_dirty = true;
+    }
+    void SetLayerScale(Vector2 scale) {
+        m_scale = scale;
+        m_dirty = true;
+    }
+    void DeltaLayerPosition(Vector2 pos) {
+        m_position = m_position + pos;
+        m_dirty = true;
+    }
+    void DeltaLayerRotation(float angle) {
+        m_rotation += angle;
+        m_dirty = true;
+    }
+    void DeltaLayerScale(Vector2 scale) {
+        m_scale = m_scale + scale;
+        m_dirty = true;
+    }
 
     Layer &Position(Vector2 pos);
     Layer &Rotation(float angle);
     Layer &Scale(Vector2 scale);
 
-    void SetVisible(bool visible) { m_visible = visible; };
+    void SetVisible(bool visible) {
+        m_visible = visible;
+        m_dirty = true;
+    }
     void SetOpacity(float opacity) {
         m_opacity = std::clamp(opacity, 0.0f, 1.0f);
-    };
-    void SetBlendMode(BlendMode mode) { m_blendMode = mode; };
+        m_dirty = true;
+    }
+    void SetBlendMode(BlendMode mode) {
+        m_blendMode = mode;
+        m_dirty = true;
+    }
+    // How much the camera's movement shifts this layer, (1, 1) moves with
+    // the world and (0.5, 0.5) scrolls at half speed for backgrounds.
+    void SetParallax(Vector2 parallax) {
+        m_parallax = parallax;
+        m_dirty = true;
+    }
+    // Screen space layers ignore the camera entirely, for UI
+    void SetScreenSpace(bool screenSpace) {
+        m_screenSpace = screenSpace;
+        m_dirty = true;
+    }
+    void SetSortMode(SortMode mode) {
+        m_sortMode = mode;
+        m_dirty = true;
+    }
+    // Puts the renderables in sort mode order, Render and UpdateBounds call
+    // it. Last frame's order is the starting point, so when only a few keys
+    // changed this is little more than one pass.
+    void Sort();
 
     int GetLayerId() const { return m_layerId; }
     const std::string &GetName() const { return m_name; }
@@ -49,20 +105,81 @@ class Layer {
     const Vector2 &GetPosition() const { return m_position; }
     float GetRotation() const { return m_rotation; }
     const Vector2 &GetScale() const { return m_scale; }
+    Vector2 GetParallax() const { return m_parallax; }
+    bool IsScreenSpace() const { return m_screenSpace; }
+    SortMode GetSortMode() const { return m_sortMode; }
+    Transform2D GetLayerTransform() const {
+        return Transform2D::FromTRS(m_position, m_rotation, m_scale);
+    }
     std::vector<Renderable *> GetRenderables() const;
-    void Render(Renderer &renderer);
+    // Same, allocated from memory, e.g. the engine's frame allocator
+    std::pmr::vector<Renderable *>
+    GetRenderables(std::pmr::memory_resource *memory) const;
+    size_t GetRenderableCount() const { return m_renderables.size(); }
+    // Calls fn(Renderable &) for each renderable without building a list
+    template <typename Fn> void ForEachRenderable(Fn &&fn) {
+        for (auto &renderable : m_renderables) {
+            fn(*renderable);
+        }
+    }
+    template <typename Fn> void ForEachRenderable(Fn &&fn) const {
+        for (const auto &renderable : m_renderables) {
+            fn(static_cast<const Renderable &>(*renderable));
+        }
+    }
+    // With a visible rect, in screen space, renderables whose bounds fall
+    // outside it are skipped.
+    void Render(Renderer &renderer, const Rect *visibleRect = nullptr);
+    // Draws only the given renderables of this layer, in that order
+    void Render(Renderer &renderer, const std::vector<Renderable *> &visible);
+
+    // Caches every renderable's bounds in layer space so several views can
+    // cull against them without recomputing transforms.
+    void UpdateBounds();
+    // Appends the renderables whose cached bounds overlap rect (layer space)
+    void Cull(const Rect &rect, std::vector<Renderable *> &out) const;
+
+    // For changes made from outside, like the RenderManager reordering it
+    void MarkDirty() { m_dirty = true; }
+    // Damage tracking: true once after a change to the layer itself, which
+    // affects everything drawn in it.
+    bool TakeDirty() {
+        bool dirty = m_dirty;
+        m_dirty = false;
+        return dirty;
+    }
+    // Screen area last covered by renderables removed since the last call
+    bool TakeRemovedDamage(Rect &damage);
 
   private:
     int m_layerId;
     std::string m_name;
-    std::vector<std::unique_ptr<Renderable>> m_renderables;
+    std::vector<RenderablePtr> m_renderables;
     std::unordered_map<std::string, Renderable *> m_nameMap;
+    // parallel to m_renderables, filled by UpdateBounds
+    std::vector<Rect> m_bounds;
+    std::vector<bool> m_hasBounds;
+    bool m_dirty = true;
+    Rect m_removedDamage;
+    bool m_hasRemovedDamage = false;
+    void AddRemovedDamage(const Renderable &renderable);
+    void RenderItem(Renderer &renderer, Renderable &renderable);
+    uint64_t GetSortKey(const Renderable &renderable) const;
+    void SortFully();
+    void BeginCommands(Renderer &renderer) const;
     Vector2 m_position = Vector2(0.0f, 0.0f);
     float m_rotation = 0.0f;
     Vector2 m_scale = Vector2(1.0f, 1.0f);
     bool m_visible = true;
     float m_opacity = 1.0f;
     BlendMode m_blendMode = BlendMode::Blend;
+    Vector2 m_parallax = Vector2(1.0f, 1.0f);
+    bool m_screenSpace = false;
+    SortMode m_sortMode = SortMode::None;
+    // sort scratch, reused by every sort
+    std::vector<uint64_t> m_sortKeys;
+    std::vector<uint32_t> m_sortOrder;
+    std::vector<RenderablePtr> m_sortScratch;
 };
 } // namespace Engine
 #endif
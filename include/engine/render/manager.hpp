@@ -1,9 +1,18 @@
 #ifndef _RENDER_MANAGER_HPP
 #define _RENDER_MANAGER_HPP
+#include <cstdint>
+#include <engine/core/commands.hpp>
+#include <engine/render/camera.hpp>
 #include <engine/render/layer.hpp>
-#include <map>
+#include <engine/render/renderable.hpp>
+#include <engine/render/view.hpp>
+#include <engine/util/memory.hpp>
+#include <engine/util/pool.hpp>
 #include <memory>
+#include <memory_resource>
 #include <string_view>
+#include <typeindex>
+#include <typeinfo>
 #include <unordered_map>
 #include <vector>
 namespace Engine {
@@ -18,41 +27,172 @@ constexpr int USER_DEFINED_START = 10000;
 } // namespace Layers
 class RenderManager {
   public:
-    RenderManager() = default;
+    RenderManager();
     ~RenderManager();
 
-    void AddRenderable(std::unique_ptr<Renderable> renderable,
-                       int layerId = Layers::WORLD);
+    void AddRenderable(RenderablePtr renderable, int layerId = Layers::WORLD);
+    // Constructs a T in this manager's pool for T and adds it to the layer.
+    // Spawning and removing such renderables reuses pool slots instead of
+    // going through the global allocator.
+    template <typename T, typename... Args>
+    T *Create(int layerId, Args &&...args) {
+        RenderablePtr renderable = MakePooled<T>(std::forward<Args>(args)...);
+        T *created = static_cast<T *>(renderable.get());
+        AddRenderable(std::move(renderable), layerId);
+        return created;
+    }
+    // Pooled like Create but not added yet, so it can be set up first.
+    // Names in particular must be set before AddRenderable to be findable.
+    template <typename T, typename... Args>
+    RenderablePtr MakePooled(Args &&...args) {
+        MemoryScope memoryScope(MemoryTag::RenderManager);
+        ObjectPool<T> &pool = GetPool<T>();
+        T *renderable = pool.Allocate(std::forward<Args>(args)...);
+        return RenderablePtr(renderable,
+                             RenderableDeleter(&FreeToPool<T>, &pool));
+    }
+    template <typename T> ObjectPool<T> &GetPool() {
+        std::unique_ptr<PoolBase> &pool = m_pools[std::type_index(typeid(T))];
+        if (!pool) {
+            pool = std::make_unique<ObjectPool<T>>();
+        }
+        return static_cast<ObjectPool<T> &>(*pool);
+    }
     bool RemoveRenderable(std::string_view name);
     Renderable *GetRenderable(std::string_view name);
     Renderable *GetRenderableInLayer(std::string_view name, int layerId);
     std::vector<Renderable *> GetRenderablesInLayer(int layerId);
+    // Same, allocated from memory, e.g. the engine's frame allocator
+    std::pmr::vector<Renderable *>
+    GetRenderablesInLayer(int layerId, std::pmr::memory_resource *memory);
 
+    // Creates the layer on first use. Layers live in one vector, so the
+    // reference is only good until another layer is created or reordered.
     Layer &GetLayer(int layerId);
     bool HasLayer(int layerId) const;
+    // Layers draw back to front by order, which starts out as the id. Equal
+    // orders draw in the order the layers were created.
+    void SetLayerOrder(int layerId, int order);
+    int GetLayerOrder(int layerId) const;
 
+    // Creates a layer under an id no other layer or name in this manager
+    // uses. It goes directly behind layerInFront if given, otherwise in
+    // front of the built in layers.
     int CreateCustomLayer(int layerInFront = -1);
     int CreateCustomLayer(std::string_view layerName, int layerInFront = -1);
     void RegisterLayerName(int layerId, std::string_view layerName);
     std::string_view GetLayerName(int layerId);
 
+    // Calls fn(const Layer &) for every layer, back to front
+    template <typename Fn> void ForEachLayer(Fn &&fn) const {
+        for (const Layer &layer : m_layers) {
+            fn(layer);
+        }
+    }
+    const std::unordered_map<std::string, std::vector<int>> &
+    GetLayerGroups() const {
+        return m_layerGroups;
+    }
+
     void CreateLayerGroup(std::string_view groupName,
                           const std::vector<int> &layerIds);
     void SetGroupVisible(std::string_view groupName, bool visible);
     void SetGroupOpacity(std::string_view groupName, float opacity);
 
+    // Renders through this camera and culls against its view, nullptr draws
+    // in screen space without culling. The camera must outlive its use here.
+    void SetCamera(const Camera2D *camera) { m_camera = camera; }
+    const Camera2D *GetCamera() const { return m_camera; }
+
+    // With views, RenderAll draws each enabled view into its viewport instead
+    // of the single full window pass. Returns the view's index.
+    int AddView(const RenderView &view);
+    RenderView &GetView(int index) { return m_views[index]; }
+    void RemoveView(int index);
+    void ClearViews();
+    size_t GetViewCount() const { return m_views.size(); }
+
     void RenderAll(Renderer &renderer);
+
+    // Damage tracking keeps the last frame in the renderer's retained target
+    // and redraws only the area covered by renderables that changed, were
+    // added or removed. A change to a layer, the camera or the window size,
+    // or a dirty renderable without bounds, redraws everything.
+    void SetDamageTracking(bool enabled) { m_damageTracking = enabled; }
+    bool IsDamageTracking() const { return m_damageTracking; }
+    // Draws the frame in damage tracking mode. Returns false, drawing
+    // nothing, when nothing changed unless force is set, in which case the
+    // retained frame is copied to the window again. Also returns false, with
+    // the SDL error set, when the renderer is already recording.
+    bool RenderDamaged(Renderer &renderer, Color clearColor,
+                       bool force = false);
     void RenderLayer(int layerId, Renderer &renderer);
     void RenderGroup(std::string_view groupName, Renderer &renderer);
 
+    // Drawing records the layers into a command list, which is sorted and
+    // submitted once they are done. If the renderer is already recording,
+    // the draws go to that list instead and the caller submits it, e.g. to
+    // capture a whole frame. Views and damage tracking need their own
+    // viewport or target per submission, so they refuse an outer recording
+    // and draw nothing. This is the list of the last submission, the
+    // last view's with several, kept until the next one.
+    const RenderCommandList &GetCommands() const { return m_commands; }
+
     void Clear();
     void ClearLayer(int layerId);
 
   private:
-    std::map<int, Layer> m_layers;
+    template <typename T> static void FreeToPool(Renderable *r, void *pool) {
+        static_cast<ObjectPool<T> *>(pool)->Free(static_cast<T *>(r));
+    }
+
+    struct LayerKey {
+        int order;
+        uint32_t sequence;
+        bool operator<(const LayerKey &other) const {
+            if (order != other.order) {
+                return order < other.order;
+            }
+            return sequence < other.sequence;
+        }
+    };
+
+    // declared before the layers so pooled renderables die first
+    std::unordered_map<std::type_index, std::unique_ptr<PoolBase>> m_pools;
+    // sorted by m_layerKeys, which runs parallel to it
+    std::vector<Layer> m_layers;
+    std::vector<LayerKey> m_layerKeys;
+    uint32_t m_nextLayerSequence = 0;
+    // index into m_layers by id, -1 for none. Ids up to the custom range and
+    // a little past it are looked up directly, the rest in the map.
+    std::vector<int32_t> m_layerIndex;
+    std::unordered_map<int, int32_t> m_sparseLayerIndex;
+    std::unordered_map<int, std::string> m_layerNames;
+    int m_nextCustomLayerId = Layers::USER_DEFINED_START;
     std::unordered_map<std::string, std::vector<int>> m_layerGroups;
-    static std::unordered_map<int, std::string> s_layerNames;
-    static int s_nextCustomLayerId;
+    const Camera2D *m_camera = nullptr;
+
+    bool m_damageTracking = false;
+    const Camera2D *m_lastCamera = nullptr;
+    Transform2D m_lastCameraView;
+
+    Layer *FindLayer(int layerId);
+    const Layer *FindLayer(int layerId) const;
+    int FindLayerIndex(int layerId) const;
+    void SetLayerIndex(int layerId, int32_t index);
+    Layer &InsertLayer(Layer layer, LayerKey key);
+    void RenderLayerWithCamera(Layer &layer, Renderer &renderer,
+                               const Rect *cullRect = nullptr);
+    Transform2D GetLayerViewTransform(const Layer &layer) const;
+    bool CollectDamage(Rect &damage, bool &full);
+    void RenderViews(Renderer &renderer);
+    bool BeginCommands(Renderer &renderer);
+    void SubmitCommands(Renderer &renderer);
+    RenderCommandList m_commands;
+
+    std::vector<RenderView> m_views;
+    // per view cull results
+    std::vector<std::vector<Renderable *>> m_viewCullLists;
 };
 } // namespace Engine
 #endif
@@ -0,0 +1,87 @@
+#ifndef _PARTICLES_HPP
+#define _PARTICLES_HPP
+#include <SDL3/SDL_render.h>
+#include <engine/render/renderable.hpp>
+#include <memory>
+#include <vector>
+namespace Engine {
+class Texture;
+// Spawn parameters for ParticleEmitter::Update and Emit. Angles in degrees,
+// speeds in units per second, times in seconds.
+struct EmitterProps {
+    float rate = 50.0f;
+    float lifetimeMin = 1.0f;
+    float lifetimeMax = 2.0f;
+    float speedMin = 50.0f;
+    float speedMax = 100.0f;
+    float direction = -90.0f;
+    float spread = 30.0f;
+    float sizeStart = 8.0f;
+    float sizeEnd = 2.0f;
+    Vector2 gravity = Vector2(0.0f, 0.0f);
+    // alpha goes from the particle's color to zero over its lifetime
+    bool fadeOut = true;
+};
+
+// Fixed-capacity pool of particles drawn as one textured geometry call.
+// Particle positions are in the parent layer's space, the emitter's position
+// only sets where new particles appear. Nothing allocates after construction.
+class ParticleEmitter : public Renderable {
+  public:
+    ParticleEmitter(size_t capacity, std::shared_ptr<Texture> texture = nullptr,
+                    const EmitterProps &props = EmitterProps());
+
+    void Render(Renderer &renderer) override;
+    RenderableType GetType() const override {
+        return RenderableType::Particles;
+    }
+
+    // Spawns at props.rate, ages and moves particles and removes dead ones
+    void Update(float dt);
+    // Spawns count particles from the props right away
+    void Emit(int count);
+    // O(1), returns false when the pool is full or lifetime is not positive
+    bool Spawn(Vector2 pos, Vector2 velocity, float lifetime, Color color,
+               float size);
+    // O(1), moves the last particle into index. Out of range does nothing.
+    void Kill(size_t index);
+    void KillAll() {
+        m_count = 0;
+        MarkDirty();
+    }
+
+    void SetProps(const EmitterProps &props) { m_props = props; }
+    const EmitterProps &GetProps() const { return m_props; }
+
+    void SetEmitting(bool emitting) { m_emitting = emitting; }
+    bool IsEmitting() const { return m_emitting; }
+
+    void SetTexture(std::shared_ptr<Texture> texture) { m_texture = texture; }
+    std::shared_ptr<Texture> GetTexture() const { return m_texture; }
+    const Texture *GetDrawTexture() const override { return m_texture.get(); }
+
+    size_t GetCount() const { return m_count; }
+    size_t GetCapacity() const { return m_capacity; }
+
+  private:
+    std::shared_ptr<Texture> m_texture;
+    EmitterProps m_props;
+    bool m_emitting = true;
+    float m_emitAccumulator = 0.0f;
+    Uint64 m_randomState = 0x9E3779B97F4A7C15ull;
+
+    // SoA pool, the first m_count entries are alive
+    size_t m_capacity = 0;
+    size_t m_count = 0;
+    std::vector<float> m_posX, m_posY;
+    std::vector<float> m_velX, m_velY;
+    std::vector<float> m_age, m_lifetime;
+    std::vector<float> m_size;
+    std::vector<Color> m_colors;
+
+    std::vector<SDL_Vertex> m_vertices;
+    // the same quad pattern for every particle, built once
+    std::vector<int> m_indices;
+};
+} // namespace Engine
+#endif
@@ -4,7 +4,9 @@
 #include <SDL3/SDL_stdinc.h>
 #include <array>
 #include <engine/util/color.hpp>
+#include <engine/util/math.hpp>
 #include <engine/util/rect.hpp>
+#include <engine/util/transform.hpp>
 #include <engine/util/vec2.hpp>
 #include <memory>
 #include <string>
@@ -15,7 +17,17 @@ namespace Engine {
 class Renderer;
 class Texture;
 enum class Flip { None, Horizontal, Vertical };
-enum class RenderableType { Sprite, Text, Rectangle, Line, Triangle, Circle };
+enum class RenderableType {
+    Sprite,
+    Text,
+    Rectangle,
+    Line,
+    Triangle,
+    Circle,
+    Polygon,
+    Polyline,
+    Particles,
+};
 class Texture;
 
 class Renderable {
@@ -26,47 +38,187 @@ class Renderable {
     virtual void Render(Renderer &renderer) = 0;
     virtual RenderableType GetType() const = 0;
 
-    void SetPosition(Vector2 pos) { m_position = pos; }
+    void SetPosition(Vector2 pos) {
+        m_position = pos;
+        MarkDirty();
+    }
     Vector2 GetPosition() const { return m_position; }
 
-    void TranslateX(float dx) { m_position.x += dx; }
-    void TranslateY(float dy) { m_position.y += dy; }
-    void Move(Vector2 delta) { m_position = m_position + delta; }
+    void TranslateX(float dx) {
+        m_position.x += dx;
+        MarkDirty();
+    }
+    void TranslateY(float dy) {
+        m_position.y += dy;
+        MarkDirty();
+    }
+    void Move(Vector2 delta) {
+        m_position = m_position + delta;
+        MarkDirty();
+    }
 
-    void SetRotation(float angleDegrees) { m_rotation = angleDegrees; }
+    // Rotation and scale must go through these setters, they invalidate the
+    // cached sin/cos and transform used by GetLocalTransform.
+    void SetRotation(float angleDegrees) {
+        m_rotation = angleDegrees;
+        m_transformDirty = true;
+        MarkDirty();
+    }
     float GetRotation() const { return m_rotation; }
-    void Rotate(float deltaDegrees) { m_rotation += deltaDegrees; }
+    void Rotate(float deltaDegrees) {
+        m_rotation += deltaDegrees;
+        m_transformDirty = true;
+        MarkDirty();
+    }
 
-    void SetScale(Vector2 scale) { m_scale = scale; }
+    void SetScale(Vector2 scale) {
+        m_scale = scale;
+        m_transformDirty = true;
+        MarkDirty();
+    }
     Vector2 GetScale() const { return m_scale; }
     void Scale(Vector2 scale) {
         m_scale.x *= scale.x;
         m_scale.y *= scale.y;
+        m_transformDirty = true;
+        MarkDirty();
     }
     void Scale(float scale) { Scale({scale, scale}); }
 
-    void SetPivot(Vector2 pivot) { m_pivot = pivot; }
+    // Use the polynomial sin/cos when the rotation changes. Meant for large
+    // numbers of objects spinning every frame, accurate to about 1e-6.
+    void SetFastRotation(bool fast) {
+        m_fastRotation = fast;
+        m_transformDirty = true;
+    }
+    bool IsFastRotation() const { return m_fastRotation; }
+
+    // Translation * Rotation * Scale of this renderable, without any layer.
+    // Only the translation is read fresh, the rest is cached until rotation
+    // or scale change.
+    Transform2D GetLocalTransform() const {
+        if (m_transformDirty) {
+            UpdateTransformCache();
+        }
+        Transform2D transform = m_transformCache;
+        transform.tx = m_position.x;
+        transform.ty = m_position.y;
+        return transform;
+    }
+
+    void SetPivot(Vector2 pivot) {
+        m_pivot = pivot;
+        MarkDirty();
+    }
     Vector2 GetPivot() const { return m_pivot; }
 
-    void SetColor(Color color) { m_color = color; }
+    void SetColor(Color color) {
+        m_color = color;
+        MarkDirty();
+    }
     Color GetColor() const { return m_color; }
 
+    // Draw order within layers sorting by z, higher draws on top
+    void SetZ(float z) {
+        m_z = z;
+        MarkDirty();
+    }
+    float GetZ() const { return m_z; }
+
+    // The texture drawn with, nullptr for untextured shapes. Layers sorting
+    // by texture group renderables that share one.
+    virtual const Texture *GetDrawTexture() const { return nullptr; }
+
     void SetName(std::string_view name) { m_name = name; }
     const std::string &GetName() const { return m_name; }
 
-    void SetVisible(bool visible) { m_visible = visible; }
+    void SetVisible(bool visible) {
+        m_visible = visible;
+        MarkDirty();
+    }
     bool IsVisible() const { return m_visible; }
 
+    // Set by anything that changes how the renderable looks, cleared by
+    // RenderManager's damage tracking once the change is accounted for.
+    void MarkDirty() { m_dirty = true; }
+    void ClearDirty() { m_dirty = false; }
+    bool IsDirty() const { return m_dirty; }
+
+    // Screen bounds last used for damage tracking, owned by RenderManager
+    void SetDamageBounds(const Rect &bounds, bool valid) {
+        m_damageBounds = bounds;
+        m_hasDamageBounds = valid;
+    }
+    bool GetDamageBounds(Rect &bounds) const {
+        bounds = m_damageBounds;
+        return m_hasDamageBounds;
+    }
+
+    // Bounds before GetLocalTransform is applied, used for culling. Returns
+    // false when unknown, such renderables are never culled.
+    virtual bool GetLocalBounds(Rect &bounds) const { return false; }
+
   protected:
     Vector2 m_position = Vector2(0.0f, 0.0f);
     float m_rotation = 0.0f;
     Vector2 m_scale = Vector2(1.0f, 1.0f);
     Vector2 m_pivot = Vector2(0.5f, 0.5f);
     Color m_color = Color::White();
+    float m_z = 0.0f;
     bool m_visible = true;
     std::string m_name;
+
+  private:
+    void UpdateTransformCache() const {
+        float sinTheta = 0.0f;
+        float cosTheta = 1.0f;
+        if (m_rotation != 0.0f) {
+            if (m_fastRotation) {
+                FastSinCosDegrees(m_rotation, sinTheta, cosTheta);
+            } else {
+                SinCosDegrees(m_rotation, sinTheta, cosTheta);
+            }
+        }
+        m_transformCache = Transform2D::FromTRS(Vector2(0.0f, 0.0f), sinTheta,
+                                                cosTheta, m_scale);
+        m_transformDirty = false;
+    }
+
+    mutable Transform2D m_transformCache;
+    mutable bool m_transformDirty = true;
+    bool m_fastRotation = false;
+
+    bool m_dirty = true;
+    Rect m_damageBounds;
+    bool m_hasDamageBounds = false;
 };
 
+// Deleter for renderables that may come from an ObjectPool. Default
+// constructed, or converted from std::default_delete, it calls delete, so
+// std::unique_ptr<Renderable> still converts to RenderablePtr.
+struct RenderableDeleter {
+    using DestroyFn = void (*)(Renderable *renderable, void *pool);
+
+    RenderableDeleter() = default;
+    RenderableDeleter(DestroyFn destroy, void *pool) {
+        this->destroy = destroy;
+        this->pool = pool;
+    }
+    template <typename T> RenderableDeleter(const std::default_delete<T> &) {}
+
+    void operator()(Renderable *renderable) const {
+        if (destroy != nullptr) {
+            destroy(renderable, pool);
+        } else {
+            delete renderable;
+        }
+    }
+
+    DestroyFn destroy = nullptr;
+    void *pool = nullptr;
+};
+using RenderablePtr = std::unique_ptr<Renderable, RenderableDeleter>;
+
 class Sprite : public Renderable {
   public:
     Sprite(std::shared_ptr<Texture> texture, Vector2 pos = Vector2(0.0f, 0.0f));
@@ -76,13 +228,26 @@ class Sprite : public Renderable {
 
     void SetTexture(std::shared_ptr<Texture> texture);
     std::shared_ptr<Texture> GetTexture() const { return m_texture; }
+    const Texture *GetDrawTexture() const override { return m_texture.get(); }
 
-    void SetSourceRect(const Rect &rect) { m_sourceRect = rect; }
+    void SetSourceRect(const Rect &rect) {
+        m_sourceRect = rect;
+        MarkDirty();
+    }
     Rect GetSourceRect() const { return m_sourceRect; }
 
-    void SetFlip(Flip flip) { m_flip = flip; }
+    void SetFlip(Flip flip) {
+        m_flip = flip;
+        MarkDirty();
+    }
     Flip GetFlip() const { return m_flip; }
 
+    bool GetLocalBounds(Rect &bounds) const override {
+        bounds = Rect(-m_pivot.x * m_sourceRect.w, -m_pivot.y * m_sourceRect.h,
+                      m_sourceRect.w, m_sourceRect.h);
+        return true;
+    }
+
   private:
     std::shared_ptr<Texture> m_texture = nullptr;
     Rect m_sourceRect = Rect(0.0f, 0.0f, 0.0f, 0.0f);
@@ -102,13 +267,23 @@ class RectangleShape : public Renderable {
     void SetDimensions(float width, float height) {
         m_width = width;
         m_height = height;
+        MarkDirty();
     }
     float GetWidth() const { return m_width; }
     float GetHeight() const { return m_height; }
 
-    void SetFilled(bool filled) { m_filled = filled; }
+    void SetFilled(bool filled) {
+        m_filled = filled;
+        MarkDirty();
+    }
     bool IsFilled() const { return m_filled; }
 
+    bool GetLocalBounds(Rect &bounds) const override {
+        bounds = Rect(-m_pivot.x * m_width, -m_pivot.y * m_height, m_width,
+                      m_height);
+        return true;
+    }
+
   private:
     float m_width = 0.0f;
     float m_height = 0.0f;
@@ -123,14 +298,26 @@ class Line : public Renderable {
 
     RenderableType GetType() const override { return RenderableType::Line; }
 
-    void SetRelativeEndPoint(Vector2 delta) { m_relativeEndPoint = delta; }
+    void SetRelativeEndPoint(Vector2 delta) {
+        m_relativeEndPoint = delta;
+        MarkDirty();
+    }
     Vector2 GetRelativeEndPoint() const { return m_relativeEndPoint; }
 
     void SetAbsoluteEndPoint(Vector2 end) {
         m_relativeEndPoint = end - m_position;
+        MarkDirty();
     }
     Vector2 GetAbsoluteEndPoint();
 
+    bool GetLocalBounds(Rect &bounds) const override {
+        bounds = Rect(SDL_min(0.0f, m_relativeEndPoint.x),
+                      SDL_min(0.0f, m_relativeEndPoint.y),
+                      SDL_fabsf(m_relativeEndPoint.x),
+                      SDL_fabsf(m_relativeEndPoint.y));
+        return true;
+    }
+
   private:
     Vector2 m_relativeEndPoint = Vector2(0.0f, 0.0f);
 };
@@ -145,30 +332,28 @@ class TriangleShape : public Renderable {
     RenderableType GetType() const override { return RenderableType::Triangle; }
 
     void SetVertices(Vector2 pos1, Vector2 pos2, Vector2 pos3);
+    // Relative to the position, which SetVertices puts at their centroid
+    std::array<Vector2, 3> GetVertices() const {
+        return {m_relVertex1, m_relVertex2, m_relVertex3};
+    }
 
     std::array<Vector2, 3> GetAbsoluteVertices() const {
-        return {CalculateAbsoluteVertex(m_relVertex1),
-                CalculateAbsoluteVertex(m_relVertex2),
-                CalculateAbsoluteVertex(m_relVertex3)};
+        Transform2D transform = GetLocalTransform();
+        return {transform.Apply(m_relVertex1), transform.Apply(m_relVertex2),
+                transform.Apply(m_relVertex3)};
     }
 
-    void SetFilled(bool filled) { m_filled = filled; }
+    void SetFilled(bool filled) {
+        m_filled = filled;
+        MarkDirty();
+    }
     bool IsFilled() const { return m_filled; }
 
+    bool GetLocalBounds(Rect &bounds) const override;
+
   private:
     Vector2 m_relVertex1, m_relVertex2, m_relVertex3;
     bool m_filled = false;
-
-    Vector2 CalculateAbsoluteVertex(const Vector2 &relVertex) const {
-        float rad = m_rotation * (M_PI / 180.0f);
-        float cosTheta = SDL_cosf(rad);
-        float sinTheta = SDL_sinf(rad);
-
-        return {m_position.x + (relVertex.x * m_scale.x * cosTheta -
-                                relVertex.y * m_scale.y * sinTheta),
-                m_position.y + (relVertex.x * m_scale.x * sinTheta +
-                                relVertex.y * m_scale.y * cosTheta)};
-    }
 };
 
 class CircleShape : public Renderable {
@@ -178,17 +363,135 @@ class CircleShape : public Renderable {
     void Render(Renderer &renderer) override;
     RenderableType GetType() const override { return RenderableType::Circle; }
 
-    void SetRadius(float radius) { m_radius = radius; }
+    void SetRadius(float radius) {
+        m_radius = radius;
+        MarkDirty();
+    }
     float GetRadius() const { return m_radius; }
 
-    void SetFilled(bool filled) { m_filled = filled; }
+    void SetFilled(bool filled) {
+        m_filled = filled;
+        MarkDirty();
+    }
     bool IsFilled() const { return m_filled; }
 
+    // Segments used for the given on-screen radius, a multiple of 4 between
+    // 8 and 128 chosen so the outline deviates less than a quarter pixel.
+    static int SegmentsForRadius(float screenRadius);
+
+    bool GetLocalBounds(Rect &bounds) const override {
+        bounds = Rect(-m_radius, -m_radius, m_radius * 2.0f, m_radius * 2.0f);
+        return true;
+    }
+
   private:
     float m_radius = 0.0f;
     bool m_filled = false;
-    Vector2 TransformPoint(float x, float y) const;
-    std::vector<Vector2> GetCirclePoints(int segments) const;
+
+    // The geometry lives in local space: the shared unit circle plus vertex
+    // colors and texture coordinates, rebuilt only when the color or segment
+    // count change. Moving the circle, layer or camera, or drawing it in
+    // another view, only maps the unit circle through the new transform.
+    void UpdateGeometry(int segments);
+    void UpdatePositions(const Transform2D &circleTransform);
+    Transform2D m_cachedTransform;
+    Color m_cachedColor;
+    int m_cachedSegments = 0;
+    bool m_positionsValid = false;
+    std::vector<Vector2> m_points;
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<SDL_FPoint> m_outline;
+};
+
+// Simple polygon, convex or concave, in either winding. Points are relative
+// to the position. The fill is triangulated once by ear clipping when the
+// points change and vertex colors are kept until the color changes, a new
+// transform only maps the points to the screen again.
+class PolygonShape : public Renderable {
+  public:
+    PolygonShape(Vector2 pos, std::vector<Vector2> points, Color color,
+                 bool filled = true);
+
+    void Render(Renderer &renderer) override;
+    RenderableType GetType() const override { return RenderableType::Polygon; }
+
+    void SetPoints(std::vector<Vector2> points);
+    const std::vector<Vector2> &GetPoints() const { return m_points; }
+    // Triangle list into GetPoints(), empty for self-intersecting input
+    const std::vector<int> &GetTriangles() const { return m_indices; }
+
+    void SetFilled(bool filled) {
+        m_filled = filled;
+        MarkDirty();
+    }
+    bool IsFilled() const { return m_filled; }
+
+    bool GetLocalBounds(Rect &bounds) const override {
+        bounds = m_bounds;
+        return true;
+    }
+
+  private:
+    std::vector<Vector2> m_points;
+    Rect m_bounds;
+    std::vector<int> m_indices;
+    bool m_filled = true;
+
+    void UpdateGeometry();
+    void UpdatePositions(const Transform2D &transform);
+    bool m_geometryDirty = true;
+    Transform2D m_cachedTransform;
+    Color m_cachedColor;
+    bool m_positionsValid = false;
+    std::vector<Vector2> m_transformed;
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<SDL_FPoint> m_outline;
+};
+
+// Connected line segments drawn in one call. Points are relative to the
+// position. A thickness above one pixel draws each segment as a quad of that
+// on-screen width, still in a single geometry call.
+class PolylineShape : public Renderable {
+  public:
+    PolylineShape(Vector2 pos, std::vector<Vector2> points, Color color,
+                  float thickness = 1.0f, bool closed = false);
+
+    void Render(Renderer &renderer) override;
+    RenderableType GetType() const override {
+        return RenderableType::Polyline;
+    }
+
+    void SetPoints(std::vector<Vector2> points);
+    const std::vector<Vector2> &GetPoints() const { return m_points; }
+
+    void SetThickness(float thickness);
+    float GetThickness() const { return m_thickness; }
+
+    void SetClosed(bool closed);
+    bool IsClosed() const { return m_closed; }
+
+    // Padded by the thickness, which is in screen pixels, assuming no scale
+    bool GetLocalBounds(Rect &bounds) const override {
+        float pad = m_thickness * 0.5f;
+        bounds = Rect(m_bounds.x - pad, m_bounds.y - pad,
+                      m_bounds.w + pad * 2.0f, m_bounds.h + pad * 2.0f);
+        return true;
+    }
+
+  private:
+    std::vector<Vector2> m_points;
+    Rect m_bounds;
+    float m_thickness = 1.0f;
+    bool m_closed = false;
+
+    void UpdateGeometry(const Transform2D &transform);
+    bool m_geometryDirty = true;
+    Transform2D m_cachedTransform;
+    Color m_cachedColor;
+    std::vector<Vector2> m_transformed;
+    std::vector<SDL_FPoint> m_linePoints;
+    std::vector<SDL_Vertex> m_vertices;
+    std::vector<int> m_indices;
 };
 } // namespace Engine
 #endif
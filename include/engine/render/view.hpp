@@ -0,0 +1,32 @@
+#ifndef _VIEW_HPP
+#define _VIEW_HPP
+#include <engine/util/rect.hpp>
+#include <vector>
+namespace Engine {
+class Camera2D;
+// One region of the window drawn through a camera, for split screen or a
+// minimap. The camera's viewport size should match the rect's size. Views
+// share the renderables' bounds, but shapes cache their vertices for one
+// transform, so views that differ rebuild them in each view every frame.
+struct RenderView {
+    Rect viewport;
+    // nullptr draws the layers untransformed
+    const Camera2D *camera = nullptr;
+    // layer ids drawn in this view, empty for all of them
+    std::vector<int> layers;
+    bool enabled = true;
+
+    bool HasLayer(int layerId) const {
+        if (layers.empty()) {
+            return true;
+        }
+        for (int id : layers) {
+            if (id == layerId) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+} // namespace Engine
+#endif
@@ -0,0 +1,122 @@
+#ifndef _SCENE_HPP
+#define _SCENE_HPP
+#include <cstdint>
+#include <engine/util/color.hpp>
+#include <engine/util/vec2.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+namespace Engine {
+class Renderable;
+class RenderManager;
+class ResourceManager;
+class JsonValue;
+class JsonWriter;
+
+// Layers, layer groups and renderables captured from a RenderManager, saved
+// to and loaded from disk and instantiated back into a RenderManager.
+//
+// The binary encoding is the in-memory records written out one section
+// after another. Loading reads the file in one call and copies each section
+// in place, and Instantiate reserves the pools before constructing anything.
+// Records are in the writing machine's byte order, little endian in
+// practice, files from a machine of the other order fail the magic check.
+//
+// The JSON encoding holds the same data with readable field names, for
+// authoring. Optional fields fall back to the renderable type's defaults.
+// Textures are referenced by the path they were loaded from, so only
+// textures that came from ResourceManager survive a round trip. Particle
+// systems are not saved and animated sprites are saved as plain sprites.
+class Scene {
+  public:
+    // Replaces the contents with the current state of renderManager
+    void Capture(const RenderManager &renderManager);
+    // Creates the layers, groups and renderables in renderManager, next to
+    // whatever it already holds. Textures are loaded through resources,
+    // sprites whose texture fails to load are created without one.
+    void Instantiate(RenderManager &renderManager,
+                     ResourceManager &resources) const;
+    void Clear();
+
+    // Pick the encoding from the extension, .json or binary otherwise. On
+    // failure they return false with the reason in SDL_GetError().
+    bool Save(std::string_view path) const;
+    bool Load(std::string_view path);
+    bool SaveBinary(std::string_view path) const;
+    bool LoadBinary(std::string_view path);
+    bool SaveJson(std::string_view path) const;
+    bool LoadJson(std::string_view path);
+
+    size_t GetLayerCount() const { return m_layers.size(); }
+    size_t GetRenderableCount() const { return m_renderables.size(); }
+
+  private:
+    // Span of m_strings
+    struct StringRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+    struct LayerRecord {
+        int32_t id;
+        int32_t order;
+        StringRef name;
+        Vector2 position;
+        float rotation;
+        Vector2 scale;
+        float opacity;
+        Vector2 parallax;
+        uint8_t blendMode;
+        uint8_t flags;
+        uint8_t sortMode;
+        uint8_t padding;
+    };
+    // Span of m_groupLayers
+    struct GroupRecord {
+        StringRef name;
+        uint32_t firstLayer;
+        uint32_t layerCount;
+    };
+    // params by type: sprite source rect, rectangle size, line end relative
+    // to the position, triangle vertices relative to the position, circle
+    // radius, polyline thickness. Polygons and polylines own a span of
+    // m_points.
+    struct RenderableRecord {
+        uint8_t type;
+        uint8_t flags;
+        uint8_t flip;
+        uint8_t padding;
+        int32_t layerId;
+        StringRef name;
+        int32_t texture;
+        Vector2 position;
+        float rotation;
+        float z;
+        Vector2 scale;
+        Vector2 pivot;
+        Color color;
+        float params[6];
+        uint32_t firstPoint;
+        uint32_t pointCount;
+    };
+
+    void CaptureRenderable(const Renderable &renderable, int layerId);
+    StringRef AddString(std::string_view text);
+    std::string_view GetString(StringRef ref) const;
+    int32_t AddTexture(std::string_view path);
+    // Checks every index and span after a load, so Instantiate can trust them
+    bool Validate() const;
+
+    void WriteJson(JsonWriter &writer) const;
+    bool ReadJson(const JsonValue &document);
+    bool ReadJsonRenderable(const JsonValue &value);
+
+    std::vector<LayerRecord> m_layers;
+    std::vector<GroupRecord> m_groups;
+    std::vector<int32_t> m_groupLayers;
+    std::vector<StringRef> m_textures;
+    std::vector<RenderableRecord> m_renderables;
+    std::vector<Vector2> m_points;
+    std::string m_strings;
+};
+} // namespace Engine
+#endif
@@ -32,6 +32,11 @@ class Color {
     static Color Blue() { return Color(0, 0, 255); }
     static Color Transparent() { return Color(0, 0, 0, 0); }
 
+    bool operator==(const Color &other) const {
+        return r == other.r && g == other.g && b == other.b && a == other.a;
+    }
+    bool operator!=(const Color &other) const { return !(*this == other); }
+
     SDL_Color ToSDLColor() const { return {r, g, b, a}; }
     SDL_FColor ToSDLFColor() const {
         return {r / 255.0f, g / 255.0f, b / 255.0f, a / 255.0f};
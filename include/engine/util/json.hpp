@@ -0,0 +1,106 @@
+#ifndef _JSON_HPP
+#define _JSON_HPP
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+namespace Engine {
+// Small JSON document for human-edited files such as scenes. Numbers are
+// doubles and objects keep their members in file order. Lookups that miss
+// return a null value, so optional fields read as their fallback.
+class JsonValue {
+  public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    JsonValue() = default;
+
+    // On failure returns false and describes the problem in error
+    static bool Parse(std::string_view text, JsonValue &out,
+                      std::string *error = nullptr);
+
+    Type GetType() const { return m_type; }
+    bool IsNull() const { return m_type == Type::Null; }
+    bool IsArray() const { return m_type == Type::Array; }
+    bool IsObject() const { return m_type == Type::Object; }
+
+    bool AsBool(bool fallback = false) const {
+        return m_type == Type::Bool ? m_bool : fallback;
+    }
+    double AsNumber(double fallback = 0.0) const {
+        return m_type == Type::Number ? m_number : fallback;
+    }
+    float AsFloat(float fallback = 0.0f) const {
+        return m_type == Type::Number ? static_cast<float>(m_number)
+                                      : fallback;
+    }
+    // The fallback too for numbers that do not fit in an int
+    int AsInt(int fallback = 0) const {
+        // written so NaN fails the check as well
+        constexpr double MIN = std::numeric_limits<int>::min() - 1.0;
+        constexpr double MAX = std::numeric_limits<int>::max() + 1.0;
+        if (m_type != Type::Number || !(m_number > MIN && m_number < MAX)) {
+            return fallback;
+        }
+        return static_cast<int>(m_number);
+    }
+    // Empty unless a string
+    const std::string &AsString() const { return m_string; }
+
+    // Elements of an array, zero otherwise
+    size_t Size() const { return m_array.size(); }
+    const JsonValue &operator[](size_t index) const;
+    const JsonValue &operator[](std::string_view key) const;
+    const std::vector<JsonValue> &GetArray() const { return m_array; }
+    const std::vector<std::pair<std::string, JsonValue>> &GetMembers() const {
+        return m_members;
+    }
+
+  private:
+    friend class JsonParser;
+
+    Type m_type = Type::Null;
+    bool m_bool = false;
+    double m_number = 0.0;
+    std::string m_string;
+    std::vector<JsonValue> m_array;
+    std::vector<std::pair<std::string, JsonValue>> m_members;
+};
+
+// Appends pretty printed JSON to a string. Objects put one member per line,
+// arrays opened with inlined = true stay on one line, for vectors and
+// colors.
+class JsonWriter {
+  public:
+    explicit JsonWriter(std::string &out) : m_out(out) {}
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray(bool inlined = false);
+    void EndArray();
+
+    // Names the next value, inside an object
+    void Key(std::string_view key);
+    void Value(double value);
+    void Value(bool value);
+    void Value(std::string_view value);
+    void Value(const char *value) { Value(std::string_view(value)); }
+    void Value(int value) { Value(static_cast<double>(value)); }
+    void Value(float value) { Value(static_cast<double>(value)); }
+
+  private:
+    struct Scope {
+        bool inlined;
+        size_t count;
+    };
+    void BeforeValue();
+    void NewLine(size_t depth);
+    void WriteString(std::string_view value);
+
+    std::string &m_out;
+    std::vector<Scope> m_scopes;
+    bool m_afterKey = false;
+};
+} // namespace Engine
+#endif
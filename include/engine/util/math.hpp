@@ -0,0 +1,46 @@
+#ifndef _MATH_HPP
+#define _MATH_HPP
+#include <SDL3/SDL_stdinc.h>
+namespace Engine {
+inline void SinCosDegrees(float degrees, float &sinOut, float &cosOut) {
+    float rad = degrees * (SDL_PI_F / 180.0f);
+    sinOut = SDL_sinf(rad);
+    cosOut = SDL_cosf(rad);
+}
+
+// Polynomial sin/cos of an angle in degrees, absolute error below 1e-6.
+// Avoids two libm calls for objects that rotate every frame.
+inline void FastSinCosDegrees(float degrees, float &sinOut, float &cosOut) {
+    // split into a multiple of 90 degrees and a remainder in [-45, 45] where
+    // short series are accurate
+    float quadrant = degrees * (1.0f / 90.0f);
+    int q = static_cast<int>(quadrant + (quadrant >= 0.0f ? 0.5f : -0.5f));
+    float x = (degrees - 90.0f * static_cast<float>(q)) * (SDL_PI_F / 180.0f);
+    float x2 = x * x;
+    float s = x * (1.0f + x2 * (-1.0f / 6.0f +
+                                x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f))));
+    float c = 1.0f +
+              x2 * (-0.5f +
+                    x2 * (1.0f / 24.0f +
+                          x2 * (-1.0f / 720.0f + x2 * (1.0f / 40320.0f))));
+    switch (q & 3) {
+    case 0:
+        sinOut = s;
+        cosOut = c;
+        break;
+    case 1:
+        sinOut = c;
+        cosOut = -s;
+        break;
+    case 2:
+        sinOut = -s;
+        cosOut = -c;
+        break;
+    default:
+        sinOut = -c;
+        cosOut = s;
+        break;
+    }
+}
+} // namespace Engine
+#endif
@@ -0,0 +1,91 @@
+#ifndef _MEMORY_HPP
+#define _MEMORY_HPP
+#include <cstddef>
+#include <cstdint>
+
+// Allocation tracking replaces the global operator new and delete, so it is
+// off unless the GAME_ENGINE_TRACK_ALLOCATIONS CMake option defines
+// ENGINE_TRACK_ALLOCATIONS to 1. When off, the API below compiles to nothing
+// and reports zeroes.
+#ifndef ENGINE_TRACK_ALLOCATIONS
+#define ENGINE_TRACK_ALLOCATIONS 0
+#endif
+
+namespace Engine {
+// Subsystem an allocation is charged to, set with MemoryScope
+enum class MemoryTag : uint8_t {
+    Untagged,
+    RenderManager,
+    ResourceManager,
+    EventManager,
+    Renderer,
+    Count
+};
+
+struct MemoryStats {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t frees = 0;
+    // allocated minus freed, can go negative within a frame
+    int64_t liveBytes = 0;
+
+    MemoryStats &operator+=(const MemoryStats &other);
+};
+
+namespace Memory {
+const char *GetTagName(MemoryTag tag);
+
+#if ENGINE_TRACK_ALLOCATIONS
+constexpr bool IsTracking() { return true; }
+
+// Ends the current frame: its counts become GetLastFrameStats
+void BeginFrame();
+
+// Since startup
+MemoryStats GetTotalStats(MemoryTag tag);
+// During the last complete frame, per tag or summed over every tag
+MemoryStats GetLastFrameStats(MemoryTag tag);
+MemoryStats GetLastFrameStats();
+// So far in the current frame
+MemoryStats GetFrameStats(MemoryTag tag);
+
+// Called by the operator new and delete replacement
+MemoryTag GetCurrentTag();
+void SetCurrentTag(MemoryTag tag);
+void RecordAllocation(MemoryTag tag, size_t bytes);
+void RecordFree(MemoryTag tag, size_t bytes);
+#else
+constexpr bool IsTracking() { return false; }
+
+inline void BeginFrame() {}
+
+inline MemoryStats GetTotalStats(MemoryTag) { return {}; }
+inline MemoryStats GetLastFrameStats(MemoryTag) { return {}; }
+inline MemoryStats GetLastFrameStats() { return {}; }
+inline MemoryStats GetFrameStats(MemoryTag) { return {}; }
+#endif
+} // namespace Memory
+
+// Charges allocations made on this thread to tag until the scope ends.
+// Scopes nest, the innermost one wins.
+class MemoryScope {
+  public:
+#if ENGINE_TRACK_ALLOCATIONS
+    explicit MemoryScope(MemoryTag tag) : m_previous(Memory::GetCurrentTag()) {
+        Memory::SetCurrentTag(tag);
+    }
+    ~MemoryScope() { Memory::SetCurrentTag(m_previous); }
+#else
+    explicit MemoryScope(MemoryTag) {}
+#endif
+
+    MemoryScope(const MemoryScope &) = delete;
+    MemoryScope &operator=(const MemoryScope &) = delete;
+
+#if ENGINE_TRACK_ALLOCATIONS
+  private:
+    MemoryTag m_previous;
+#endif
+};
+} // namespace Engine
+#endif
@@ -0,0 +1,90 @@
+#ifndef _POOL_HPP
+#define _POOL_HPP
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+namespace Engine {
+// Type-erased interface so owners can keep pools of different types together.
+class PoolBase {
+  public:
+    virtual ~PoolBase() = default;
+};
+
+// Fixed-size object pool: objects live in slabs of SlabSize slots and freed
+// slots go on an intrusive free list, so allocation only touches the global
+// allocator when every slab is full. Not thread safe.
+template <typename T, size_t SlabSize = 256>
+class ObjectPool : public PoolBase {
+  public:
+    ObjectPool() = default;
+    ~ObjectPool() override = default;
+
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    template <typename... Args> T *Allocate(Args &&...args) {
+        if (m_freeList == nullptr) {
+            AddSlab();
+        }
+        // the object shares storage with next, so a throwing constructor
+        // may have clobbered it and the slot is linked back in on failure
+        Slot *slot = m_freeList;
+        Slot *next = slot->next;
+        T *object;
+        try {
+            object = new (slot->storage) T(std::forward<Args>(args)...);
+        } catch (...) {
+            slot->next = next;
+            throw;
+        }
+        m_freeList = next;
+        m_liveCount++;
+        return object;
+    }
+
+    // object must come from this pool's Allocate
+    void Free(T *object) {
+        if (object == nullptr) {
+            return;
+        }
+        object->~T();
+        Slot *slot = reinterpret_cast<Slot *>(object);
+        slot->next = m_freeList;
+        m_freeList = slot;
+        m_liveCount--;
+    }
+
+    // Adds slabs until count more objects fit without allocating
+    void Reserve(size_t count) {
+        while (GetCapacity() < m_liveCount + count) {
+            AddSlab();
+        }
+    }
+
+    size_t GetLiveCount() const { return m_liveCount; }
+    size_t GetCapacity() const { return m_slabs.size() * SlabSize; }
+
+  private:
+    union Slot {
+        Slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    // slots are pushed in reverse so allocation walks each slab in order
+    void AddSlab() {
+        m_slabs.push_back(std::make_unique<Slot[]>(SlabSize));
+        Slot *slab = m_slabs.back().get();
+        for (size_t i = SlabSize; i-- > 0;) {
+            slab[i].next = m_freeList;
+            m_freeList = &slab[i];
+        }
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> m_slabs;
+    Slot *m_freeList = nullptr;
+    size_t m_liveCount = 0;
+};
+} // namespace Engine
+#endif
@@ -1,6 +1,8 @@
 #ifndef _RECT_H
 #define _RECT_H
 #include <SDL3/SDL_rect.h>
+#include <cstddef>
+#include <engine/util/vec2.hpp>
 namespace Engine {
 class Rect {
   public:
@@ -23,6 +25,35 @@ class Rect {
     }
 
     SDL_FRect ToSDLFRect() const { return {x, y, w, h}; }
+
+    // Smallest rect containing both
+    Rect Union(const Rect &other) const {
+        float left = x < other.x ? x : other.x;
+        float top = y < other.y ? y : other.y;
+        float right = x + w > other.x + other.w ? x + w : other.x + other.w;
+        float bottom = y + h > other.y + other.h ? y + h : other.y + other.h;
+        return Rect(left, top, right - left, bottom - top);
+    }
+
+    bool Intersects(const Rect &other) const {
+        return x < other.x + other.w && other.x < x + w &&
+               y < other.y + other.h && other.y < y + h;
+    }
+    // Smallest rect containing all the points, empty for no points
+    static Rect FromPoints(const Vector2 *points, size_t count) {
+        if (count == 0) {
+            return Rect();
+        }
+        float minX = points[0].x, minY = points[0].y;
+        float maxX = minX, maxY = minY;
+        for (size_t i = 1; i < count; i++) {
+            minX = points[i].x < minX ? points[i].x : minX;
+            minY = points[i].y < minY ? points[i].y : minY;
+            maxX = points[i].x > maxX ? points[i].x : maxX;
+            maxY = points[i].y > maxY ? points[i].y : maxY;
+        }
+        return Rect(minX, minY, maxX - minX, maxY - minY);
+    }
     static Rect FromSDLFRect(const SDL_FRect &rect) {
         return Rect(rect.x, rect.y, rect.w, rect.h);
     }
@@ -0,0 +1,47 @@
+#ifndef _STARTUP_HPP
+#define _STARTUP_HPP
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+namespace Engine {
+// Startup timeline: how long each init step took, on which thread, and the
+// time from Startup::Begin to the first presented frame. Thread safe, steps
+// running in parallel record themselves.
+namespace Startup {
+struct Step {
+    std::string name;
+    // milliseconds since Begin
+    double startMs = 0.0;
+    double durationMs = 0.0;
+    bool mainThread = true;
+};
+
+// Starts the clock, call first thing in SDL_AppInit. Later calls are
+// ignored, before the first one times count from the first recorded step.
+void Begin();
+// Records the first frame, later calls do nothing. Returns true the once.
+bool MarkFirstFrame();
+// Milliseconds from Begin to MarkFirstFrame, negative until then
+double GetTimeToFirstFrame();
+// In the order the steps finished
+std::vector<Step> GetSteps();
+
+// Records the enclosing scope as a step. mainThread marks steps that must
+// stay on the main thread, the rest could overlap it.
+class StepScope {
+  public:
+    explicit StepScope(std::string_view name, bool mainThread = true);
+    ~StepScope();
+
+    StepScope(const StepScope &) = delete;
+    StepScope &operator=(const StepScope &) = delete;
+
+  private:
+    std::string m_name;
+    uint64_t m_start;
+    bool m_mainThread;
+};
+} // namespace Startup
+} // namespace Engine
+#endif
@@ -0,0 +1,131 @@
+#ifndef _TRANSFORM_HPP
+#define _TRANSFORM_HPP
+#include <SDL3/SDL_stdinc.h>
+#include <cstddef>
+#include <engine/util/math.hpp>
+#include <engine/util/rect.hpp>
+#include <engine/util/vec2.hpp>
+namespace Engine {
+// 2D affine transform stored as the top two rows of a 3x3 matrix:
+//   x' = a * x + c * y + tx
+//   y' = b * x + d * y + ty
+class Transform2D {
+  public:
+    float a = 1.0f;
+    float b = 0.0f;
+    float c = 0.0f;
+    float d = 1.0f;
+    float tx = 0.0f;
+    float ty = 0.0f;
+
+    Transform2D() = default;
+    Transform2D(float a, float b, float c, float d, float tx, float ty) {
+        this->a = a;
+        this->b = b;
+        this->c = c;
+        this->d = d;
+        this->tx = tx;
+        this->ty = ty;
+    }
+
+    static Transform2D Translation(Vector2 offset) {
+        return Transform2D(1.0f, 0.0f, 0.0f, 1.0f, offset.x, offset.y);
+    }
+
+    static Transform2D Rotation(float degrees) {
+        float sinTheta, cosTheta;
+        SinCosDegrees(degrees, sinTheta, cosTheta);
+        return Transform2D(cosTheta, sinTheta, -sinTheta, cosTheta, 0.0f, 0.0f);
+    }
+
+    static Transform2D Scaling(Vector2 scale) {
+        return Transform2D(scale.x, 0.0f, 0.0f, scale.y, 0.0f, 0.0f);
+    }
+
+    // Translation * Rotation * Scaling, the order renderables and layers use
+    static Transform2D FromTRS(Vector2 position, float degrees,
+                               Vector2 scale) {
+        if (degrees == 0.0f) {
+            return Transform2D(scale.x, 0.0f, 0.0f, scale.y, position.x,
+                               position.y);
+        }
+        float sinTheta, cosTheta;
+        SinCosDegrees(degrees, sinTheta, cosTheta);
+        return FromTRS(position, sinTheta, cosTheta, scale);
+    }
+
+    static Transform2D FromTRS(Vector2 position, float sinTheta,
+                               float cosTheta, Vector2 scale) {
+        return Transform2D(cosTheta * scale.x, sinTheta * scale.x,
+                           -sinTheta * scale.y, cosTheta * scale.y, position.x,
+                           position.y);
+    }
+
+    // Applies other first, then this
+    Transform2D operator*(const Transform2D &other) const {
+        return Transform2D(a * other.a + c * other.b, b * other.a + d * other.b,
+                           a * other.c + c * other.d, b * other.c + d * other.d,
+                           a * other.tx + c * other.ty + tx,
+                           b * other.tx + d * other.ty + ty);
+    }
+
+    bool operator==(const Transform2D &other) const {
+        return a == other.a && b == other.b && c == other.c && d == other.d &&
+               tx == other.tx && ty == other.ty;
+    }
+    bool operator!=(const Transform2D &other) const {
+        return !(*this == other);
+    }
+
+    Vector2 Apply(Vector2 point) const {
+        return Vector2(a * point.x + c * point.y + tx,
+                       b * point.x + d * point.y + ty);
+    }
+
+    // Ignores the translation, for directions and extents
+    Vector2 ApplyVector(Vector2 vec) const {
+        return Vector2(a * vec.x + c * vec.y, b * vec.x + d * vec.y);
+    }
+
+    // Axis aligned bounds of the transformed rect
+    Rect ApplyBounds(const Rect &rect) const {
+        float halfW = rect.w * 0.5f;
+        float halfH = rect.h * 0.5f;
+        Vector2 center = Apply(Vector2(rect.x + halfW, rect.y + halfH));
+        float extentX = SDL_fabsf(a) * halfW + SDL_fabsf(c) * halfH;
+        float extentY = SDL_fabsf(b) * halfW + SDL_fabsf(d) * halfH;
+        return Rect(center.x - extentX, center.y - extentY, extentX * 2.0f,
+                    extentY * 2.0f);
+    }
+
+    float Determinant() const { return a * d - b * c; }
+
+    // Returns the identity for degenerate (zero scale) transforms
+    Transform2D Inverse() const {
+        float det = Determinant();
+        if (det == 0.0f) {
+            return Transform2D();
+        }
+        float invDet = 1.0f / det;
+        float ia = d * invDet;
+        float ib = -b * invDet;
+        float ic = -c * invDet;
+        float id = a * invDet;
+        return Transform2D(ia, ib, ic, id, -(ia * tx + ic * ty),
+                           -(ib * tx + id * ty));
+    }
+
+    bool IsAxisAligned() const { return b == 0.0f && c == 0.0f; }
+    Vector2 GetTranslation() const { return Vector2(tx, ty); }
+    // Length of the transformed unit axes
+    Vector2 GetScale() const {
+        return Vector2(SDL_sqrtf(a * a + b * b), SDL_sqrtf(c * c + d * d));
+    }
+};
+
+// out[i] = transform.Apply(in[i]), four points per iteration with SSE2 or
+// NEON when available. in and out may be the same array.
+void TransformPoints(const Transform2D &transform, const Vector2 *in,
+                     Vector2 *out, size_t count);
+} // namespace Engine
+#endif
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cstring>
+#include <engine/core/commands.hpp>
+#include <engine/util/memory.hpp>
+
+namespace Engine {
+namespace {
+constexpr int LAYER_SHIFT = 48;
+constexpr int BLEND_SHIFT = 44;
+constexpr int TEXTURE_SHIFT = 32;
+constexpr uint64_t MAX_LAYER = 0xFFFF;
+// later textures share the last id, which only stops them being grouped
+constexpr uint64_t MAX_TEXTURE_ID = 0xFFF;
+// open addressing, twice the ids so a probe always ends at a free slot
+constexpr int TEXTURE_SLOT_BITS = 13;
+constexpr size_t TEXTURE_SLOTS = size_t(1) << TEXTURE_SLOT_BITS;
+
+constexpr int RADIX_BITS = 8;
+constexpr size_t RADIX_SIZE = size_t(1) << RADIX_BITS;
+constexpr uint64_t RADIX_MASK = RADIX_SIZE - 1;
+} // namespace
+
+void RenderCommandList::Clear() {
+    m_commands.clear();
+    m_vertices.clear();
+    m_indices.clear();
+    m_points.clear();
+    m_rects.clear();
+    m_text.clear();
+    m_layer = 0;
+    m_reorder = false;
+    m_depth = 0;
+    // stale slots read as empty, so the table is reset without touching it
+    m_textureCount = 0;
+    if (++m_textureGeneration == 0) {
+        std::fill(m_textureSlots.begin(), m_textureSlots.end(), TextureSlot());
+        m_textureGeneration = 1;
+    }
+    m_order.clear();
+}
+
+void RenderCommandList::BeginLayer(bool reorder) {
+    m_layer = std::min(m_layer + 1, MAX_LAYER);
+    m_reorder = reorder;
+}
+
+uint64_t RenderCommandList::GetTextureId(SDL_Texture *texture) {
+    if (m_textureSlots.empty()) {
+        MemoryScope memoryScope(MemoryTag::Renderer);
+        m_textureSlots.resize(TEXTURE_SLOTS);
+    }
+    // Fibonacci hashing of the pointer, then linear probing
+    uint64_t hash = reinterpret_cast<uintptr_t>(texture) * 0x9E3779B97F4A7C15u;
+    size_t index = static_cast<size_t>(hash >> (64 - TEXTURE_SLOT_BITS));
+    while (true) {
+        TextureSlot &slot = m_textureSlots[index];
+        if (slot.generation != m_textureGeneration) {
+            if (m_textureCount >= MAX_TEXTURE_ID) {
+                return MAX_TEXTURE_ID;
+            }
+            slot.texture = texture;
+            slot.id = ++m_textureCount;
+            slot.generation = m_textureGeneration;
+            return slot.id;
+        }
+        if (slot.texture == texture) {
+            return slot.id;
+        }
+        index = (index + 1) & (TEXTURE_SLOTS - 1);
+    }
+}
+
+RenderCommand &RenderCommandList::Add(RenderCommandType type,
+                                      SDL_Texture *texture,
+                                      BlendMode blendMode, Color color) {
+    // depth alone keeps the recorded order, reordering layers put blend
+    // mode and texture above it
+    uint64_t key = m_layer << LAYER_SHIFT | m_depth++;
+    if (m_reorder) {
+        uint64_t textureId = texture != nullptr ? GetTextureId(texture) : 0;
+        key |= static_cast<uint64_t>(blendMode) << BLEND_SHIFT |
+               textureId << TEXTURE_SHIFT;
+    }
+    RenderCommand command = {};
+    command.key = key;
+    command.texture = texture;
+    command.color = color;
+    command.type = type;
+    command.blendMode = blendMode;
+    m_commands.push_back(command);
+    return m_commands.back();
+}
+
+void RenderCommandList::AddGeometry(SDL_Texture *texture, BlendMode blendMode,
+                                    const SDL_Vertex *vertices,
+                                    int numVertices, const int *indices,
+                                    int numIndices) {
+    if (numVertices <= 0) {
+        return;
+    }
+    MemoryScope memoryScope(MemoryTag::Renderer);
+    RenderCommand &command =
+        Add(RenderCommandType::Geometry, texture, blendMode, Color::White());
+    command.first = static_cast<uint32_t>(m_vertices.size());
+    command.count = static_cast<uint32_t>(numVertices);
+    m_vertices.insert(m_vertices.end(), vertices, vertices + numVertices);
+    command.firstIndex = static_cast<uint32_t>(m_indices.size());
+    if (indices != nullptr) {
+        m_indices.insert(m_indices.end(), indices, indices + numIndices);
+        command.indexCount = static_cast<uint32_t>(numIndices);
+    } else {
+        for (int i = 0; i < numVertices; i++) {
+            m_indices.push_back(i);
+        }
+        command.indexCount = static_cast<uint32_t>(numVertices);
+    }
+}
+
+void RenderCommandList::AddLines(Color color, BlendMode blendMode,
+                                 const SDL_FPoint *points, int count) {
+    if (count <= 0) {
+        return;
+    }
+    MemoryScope memoryScope(MemoryTag::Renderer);
+    RenderCommand &command =
+        Add(RenderCommandType::Lines, nullptr, blendMode, color);
+    command.first = static_cast<uint32_t>(m_points.size());
+    command.count = static_cast<uint32_t>(count);
+    m_points.insert(m_points.end(), points, points + count);
+}
+
+void RenderCommandList::AddPoints(Color color, BlendMode blendMode,
+                                  const SDL_FPoint *points, int count) {
+    if (count <= 0) {
+        return;
+    }
+    MemoryScope memoryScope(MemoryTag::Renderer);
+    RenderCommand &command =
+        Add(RenderCommandType::Points, nullptr, blendMode, color);
+    command.first = static_cast<uint32_t>(m_points.size());
+    command.count = static_cast<uint32_t>(count);
+    m_points.insert(m_points.end(), points, points + count);
+}
+
+void RenderCommandList::AddRects(Color color, BlendMode blendMode,
+                                 const SDL_FRect *rects, int count) {
+    if (count <= 0) {
+        return;
+    }
+    MemoryScope memoryScope(MemoryTag::Renderer);
+    RenderCommand &command =
+        Add(RenderCommandType::Rects, nullptr, blendMode, color);
+    command.first = static_cast<uint32_t>(m_rects.size());
+    command.count = static_cast<uint32_t>(count);
+    m_rects.insert(m_rects.end(), rects, rects + count);
+}
+
+void RenderCommandList::AddText(Color color, BlendMode blendMode, Vector2 pos,
+                                const char *text) {
+    MemoryScope memoryScope(MemoryTag::Renderer);
+    RenderCommand &command =
+        Add(RenderCommandType::Text, nullptr, blendMode, color);
+    command.first = static_cast<uint32_t>(m_points.size());
+    command.count = 1;
+    m_points.push_back(pos.ToSDLPoint());
+    command.firstIndex = static_cast<uint32_t>(m_text.size());
+    m_text.insert(m_text.end(), text, text + std::strlen(text) + 1);
+}
+
+// LSD radix sort of (key, index) pairs, a byte per pass. Passes where every
+// key has the same byte, like the layer bits of a one layer list, are
+// skipped.
+void RenderCommandList::Sort() {
+    MemoryScope memoryScope(MemoryTag::Renderer);
+    size_t count = m_commands.size();
+    m_order.resize(count);
+    bool sorted = true;
+    for (size_t i = 0; i < count; i++) {
+        m_order[i] = static_cast<uint32_t>(i);
+        if (i > 0 && m_commands[i].key < m_commands[i - 1].key) {
+            sorted = false;
+        }
+    }
+    if (sorted) {
+        return;
+    }
+
+    m_sortKeys.resize(count);
+    m_sortKeysTemp.resize(count);
+    m_orderTemp.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_sortKeys[i] = m_commands[i].key;
+    }
+    for (int shift = 0; shift < 64; shift += RADIX_BITS) {
+        uint32_t offsets[RADIX_SIZE] = {};
+        for (uint64_t key : m_sortKeys) {
+            offsets[(key >> shift) & RADIX_MASK]++;
+        }
+        if (offsets[(m_sortKeys[0] >> shift) & RADIX_MASK] == count) {
+            continue;
+        }
+        uint32_t total = 0;
+        for (uint32_t &offset : offsets) {
+            uint32_t digitCount = offset;
+            offset = total;
+            total += digitCount;
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint32_t slot = offsets[(m_sortKeys[i] >> shift) & RADIX_MASK]++;
+            m_sortKeysTemp[slot] = m_sortKeys[i];
+            m_orderTemp[slot] = m_order[i];
+        }
+        m_sortKeys.swap(m_sortKeysTemp);
+        m_order.swap(m_orderTemp);
+    }
+}
+} // namespace Engine
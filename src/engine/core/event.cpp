@@ -1,97 +1,523 @@
+#include <algorithm>
 #include <engine/core/event.hpp>
+#include <engine/util/memory.hpp>
 
 namespace Engine {
+namespace {
+// "GEIR", followed by a version. Each record is the frame delta to the
+// previous record, the SDL event type and only the fields HandleEvent reads.
+// Version 2 ends with a REPLAY_END record at the number of frames recorded.
+constexpr Uint32 REPLAY_MAGIC = 0x52494547;
+constexpr Uint32 REPLAY_VERSION = 2;
+// SDL_EVENT_FIRST, never the type of a real event
+constexpr Uint32 REPLAY_END = 0;
+
+bool WriteFloat(SDL_IOStream *io, float value) {
+    Uint32 bits;
+    SDL_memcpy(&bits, &value, sizeof(bits));
+    return SDL_WriteU32LE(io, bits);
+}
+
+bool ReadFloat(SDL_IOStream *io, float *value) {
+    Uint32 bits;
+    if (!SDL_ReadU32LE(io, &bits)) {
+        return false;
+    }
+    SDL_memcpy(value, &bits, sizeof(bits));
+    return true;
+}
+} // namespace
+
 EventManager::~EventManager() { Shutdown(); }
 
-void EventManager::Shutdown() { m_eventBindings.clear(); }
+void EventManager::Shutdown() {
+    StopRecording();
+    StopReplay();
+    m_eventBindings.clear();
+    // slots are kept with their generations bumped, so handles from before
+    // Shutdown never match a callback registered after it
+    m_freeSlots.clear();
+    for (uint32_t index = 0; index < m_slots.size(); index++) {
+        CallbackSlot &slot = m_slots[index];
+        if (slot.alive) {
+            slot.alive = false;
+            slot.generation =
+                slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+        }
+        slot.callback = nullptr;
+        m_freeSlots.push_back(index);
+    }
+    m_deadSlots.clear();
+    m_pendingSlots.clear();
+    m_pending.clear();
+}
+
+CallbackHandle EventManager::RegisterCallback(EventType eventType,
+                                              EventCallback callback,
+                                              int priority) {
+    MemoryScope memoryScope(MemoryTag::EventManager);
+    return RegisterConsumingCallback(
+        eventType,
+        [callback = std::move(callback)](const EventData &data) {
+            callback(data);
+            return false;
+        },
+        priority);
+}
+
+CallbackHandle
+EventManager::RegisterConsumingCallback(EventType eventType,
+                                        ConsumingEventCallback callback,
+                                        int priority) {
+    MemoryScope memoryScope(MemoryTag::EventManager);
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    CallbackSlot &slot = m_slots[index];
+    slot.callback = std::move(callback);
+    slot.type = eventType;
+    slot.priority = priority;
+    slot.alive = true;
+
+    if (m_dispatchDepth > 0) {
+        m_pendingSlots.push_back(index);
+    } else {
+        Bind(index);
+    }
+    return {index, slot.generation};
+}
 
-void EventManager::RegisterCallback(EventType eventType,
-                                    EventCallback callback) {
-    if (m_eventBindings.find(eventType) == m_eventBindings.end()) {
-        m_eventBindings[eventType] = std::vector<EventCallback>();
+bool EventManager::DeregisterCallback(CallbackHandle handle) {
+    if (!handle.IsValid() || handle.index >= m_slots.size()) {
+        return false;
+    }
+    CallbackSlot &slot = m_slots[handle.index];
+    if (!slot.alive || slot.generation != handle.generation) {
+        return false;
     }
-    m_eventBindings[eventType].push_back(callback);
+    slot.alive = false;
+    // skip 0 on wrap around, it marks invalid handles
+    slot.generation = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+    // the binding lists are compacted lazily after the next dispatch
+    m_deadSlots.push_back(handle.index);
+    return true;
 }
 
 bool EventManager::DeregisterCallback(EventType eventType) {
-    if (m_eventBindings.find(eventType) == m_eventBindings.end()) {
+    auto it = m_eventBindings.find(eventType);
+    bool removed = false;
+    if (it != m_eventBindings.end()) {
+        for (uint32_t index : it->second) {
+            CallbackSlot &slot = m_slots[index];
+            removed |= DeregisterCallback({index, slot.generation});
+        }
+    }
+    for (uint32_t index : m_pendingSlots) {
+        CallbackSlot &slot = m_slots[index];
+        if (slot.type == eventType) {
+            removed |= DeregisterCallback({index, slot.generation});
+        }
+    }
+    if (m_dispatchDepth == 0) {
+        Compact();
+    }
+    return removed;
+}
+
+void EventManager::Bind(uint32_t slotIndex) {
+    const CallbackSlot &slot = m_slots[slotIndex];
+    if (!slot.alive) {
+        return;
+    }
+    std::vector<uint32_t> &bindings = m_eventBindings[slot.type];
+    auto pos = std::upper_bound(bindings.begin(), bindings.end(), slot.priority,
+                                [this](int priority, uint32_t other) {
+                                    return priority > m_slots[other].priority;
+                                });
+    bindings.insert(pos, slotIndex);
+}
+
+void EventManager::Compact() {
+    if (!m_deadSlots.empty()) {
+        for (auto &[type, bindings] : m_eventBindings) {
+            bindings.erase(std::remove_if(bindings.begin(), bindings.end(),
+                                          [this](uint32_t index) {
+                                              return !m_slots[index].alive;
+                                          }),
+                           bindings.end());
+        }
+        for (uint32_t index : m_deadSlots) {
+            m_slots[index].callback = nullptr;
+            m_freeSlots.push_back(index);
+        }
+        m_deadSlots.clear();
+    }
+    for (uint32_t index : m_pendingSlots) {
+        Bind(index);
+    }
+    m_pendingSlots.clear();
+}
+
+bool EventManager::SetCoalescePolicy(EventType eventType,
+                                     CoalescePolicy policy) {
+    MemoryScope memoryScope(MemoryTag::EventManager);
+    switch (eventType) {
+    case EventType::WindowResize:
+    case EventType::MouseMove:
+    case EventType::MouseWheel:
+        break;
+    default:
+        return policy == CoalescePolicy::Immediate;
+    }
+    if (policy == CoalescePolicy::Immediate) {
+        // deliver whatever was merged so far before switching over
+        auto it = m_pending.find(eventType);
+        if (it != m_pending.end() && it->second.pending) {
+            it->second.pending = false;
+            InvokeCallback(eventType, it->second.data);
+        }
+    }
+    m_policies[eventType] = policy;
+    return true;
+}
+
+CoalescePolicy EventManager::GetCoalescePolicy(EventType eventType) const {
+    auto it = m_policies.find(eventType);
+    return it != m_policies.end() ? it->second : CoalescePolicy::Immediate;
+}
+
+void EventManager::DispatchCoalesced() {
+    for (auto &[type, pending] : m_pending) {
+        if (pending.pending) {
+            pending.pending = false;
+            InvokeCallback(type, pending.data);
+        }
+    }
+}
+
+void EventManager::Update() {
+    MemoryScope memoryScope(MemoryTag::EventManager);
+    if (m_replaying) {
+        while (m_replayCursor < m_replayEvents.size() &&
+               m_replayEvents[m_replayCursor].frame + m_replayStartFrame <=
+                   m_frame) {
+            HandleEvent(m_replayEvents[m_replayCursor].event);
+            m_replayCursor++;
+        }
+    }
+    m_frame++;
+    DispatchCoalesced();
+}
+
+bool EventManager::StartRecording(const std::string &path) {
+    MemoryScope memoryScope(MemoryTag::EventManager);
+    StopRecording();
+    SDL_IOStream *io = SDL_IOFromFile(path.c_str(), "wb");
+    if (io == nullptr) {
+        return false;
+    }
+    if (!SDL_WriteU32LE(io, REPLAY_MAGIC) ||
+        !SDL_WriteU32LE(io, REPLAY_VERSION)) {
+        SDL_CloseIO(io);
+        return false;
+    }
+    m_recordStream = io;
+    m_recordStartFrame = m_frame;
+    m_lastRecordedFrame = 0;
+    return true;
+}
+
+void EventManager::StopRecording() {
+    if (m_recordStream != nullptr) {
+        // frames after the last event count too, replay runs until here
+        uint64_t frame = m_frame - m_recordStartFrame;
+        Uint32 frameDelta = static_cast<Uint32>(frame - m_lastRecordedFrame);
+        SDL_WriteU32LE(m_recordStream, frameDelta);
+        SDL_WriteU32LE(m_recordStream, REPLAY_END);
+        SDL_CloseIO(m_recordStream);
+        m_recordStream = nullptr;
+    }
+}
+
+void EventManager::RecordEvent(const SDL_Event &event) {
+    uint64_t frame = m_frame - m_recordStartFrame;
+    SDL_IOStream *io = m_recordStream;
+    Uint32 frameDelta = static_cast<Uint32>(frame - m_lastRecordedFrame);
+    bool ok = SDL_WriteU32LE(io, frameDelta) && SDL_WriteU32LE(io, event.type);
+    m_lastRecordedFrame = frame;
+
+    switch (event.type) {
+    case SDL_EVENT_WINDOW_RESIZED:
+        ok = ok && SDL_WriteS32LE(io, event.window.data1) &&
+             SDL_WriteS32LE(io, event.window.data2);
+        break;
+    case SDL_EVENT_KEY_DOWN:
+    case SDL_EVENT_KEY_UP:
+        ok = ok && SDL_WriteU32LE(io, event.key.key) &&
+             SDL_WriteU32LE(io, event.key.scancode) &&
+             SDL_WriteU16LE(io, event.key.mod);
+        break;
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        ok = ok && SDL_WriteU8(io, event.button.button) &&
+             WriteFloat(io, event.button.x) && WriteFloat(io, event.button.y);
+        break;
+    case SDL_EVENT_MOUSE_MOTION:
+        ok = ok && WriteFloat(io, event.motion.x) &&
+             WriteFloat(io, event.motion.y) &&
+             WriteFloat(io, event.motion.xrel) &&
+             WriteFloat(io, event.motion.yrel);
+        break;
+    case SDL_EVENT_MOUSE_WHEEL:
+        ok = ok && WriteFloat(io, event.wheel.x) &&
+             WriteFloat(io, event.wheel.y);
+        break;
+    }
+    if (!ok) {
+        // disk full or similar, a truncated log is still replayable up to
+        // its last event
+        SDL_CloseIO(m_recordStream);
+        m_recordStream = nullptr;
+    }
+}
+
+bool EventManager::StartReplay(const std::string &path) {
+    MemoryScope memoryScope(MemoryTag::EventManager);
+    StopReplay();
+    SDL_IOStream *io = SDL_IOFromFile(path.c_str(), "rb");
+    if (io == nullptr) {
+        return false;
+    }
+    Uint32 magic = 0;
+    Uint32 version = 0;
+    if (!SDL_ReadU32LE(io, &magic) || !SDL_ReadU32LE(io, &version) ||
+        magic != REPLAY_MAGIC || version < 1 || version > REPLAY_VERSION) {
+        SDL_CloseIO(io);
         return false;
     }
-    m_eventBindings.erase(eventType);
+
+    uint64_t frame = 0;
+    Uint32 delta = 0;
+    Uint32 type = 0;
+    // version 1 logs and truncated ones stop after their last event
+    bool ended = false;
+    while (SDL_ReadU32LE(io, &delta) && SDL_ReadU32LE(io, &type)) {
+        frame += delta;
+        if (type == REPLAY_END) {
+            ended = true;
+            break;
+        }
+        RecordedEvent record;
+        SDL_zero(record.event);
+        record.frame = frame;
+        record.event.type = type;
+        SDL_Event &event = record.event;
+        bool ok = true;
+        switch (type) {
+        case SDL_EVENT_WINDOW_RESIZED:
+            ok = SDL_ReadS32LE(io, &event.window.data1) &&
+                 SDL_ReadS32LE(io, &event.window.data2);
+            break;
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP: {
+            Uint32 scancode = 0;
+            ok = SDL_ReadU32LE(io, &event.key.key) &&
+                 SDL_ReadU32LE(io, &scancode) &&
+                 SDL_ReadU16LE(io, &event.key.mod);
+            event.key.scancode = static_cast<SDL_Scancode>(scancode);
+            event.key.down = type == SDL_EVENT_KEY_DOWN;
+            break;
+        }
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            ok = SDL_ReadU8(io, &event.button.button) &&
+                 ReadFloat(io, &event.button.x) &&
+                 ReadFloat(io, &event.button.y);
+            event.button.down = type == SDL_EVENT_MOUSE_BUTTON_DOWN;
+            break;
+        case SDL_EVENT_MOUSE_MOTION:
+            ok = ReadFloat(io, &event.motion.x) &&
+                 ReadFloat(io, &event.motion.y) &&
+                 ReadFloat(io, &event.motion.xrel) &&
+                 ReadFloat(io, &event.motion.yrel);
+            break;
+        case SDL_EVENT_MOUSE_WHEEL:
+            ok = ReadFloat(io, &event.wheel.x) && ReadFloat(io, &event.wheel.y);
+            break;
+        default:
+            ok = false;
+            break;
+        }
+        if (!ok) {
+            break;
+        }
+        m_replayEvents.push_back(record);
+    }
+    SDL_CloseIO(io);
+
+    if (ended) {
+        m_replayFrameCount = frame;
+    } else if (!m_replayEvents.empty()) {
+        m_replayFrameCount = m_replayEvents.back().frame + 1;
+    } else {
+        m_replayFrameCount = 0;
+    }
+    m_replaying = true;
+    m_replayCursor = 0;
+    m_replayStartFrame = m_frame;
     return true;
 }
 
+void EventManager::StopReplay() {
+    m_replaying = false;
+    m_replayCursor = 0;
+    m_replayFrameCount = 0;
+    m_replayEvents.clear();
+}
+
 bool EventManager::ProcessEvent(SDL_Event *event) {
-    switch (event->type) {
+    MemoryScope memoryScope(MemoryTag::EventManager);
+    if (m_replaying) {
+        return false;
+    }
+    bool handled = HandleEvent(*event);
+    if (handled && m_recordStream != nullptr) {
+        RecordEvent(*event);
+    }
+    return handled;
+}
+
+bool EventManager::HandleEvent(const SDL_Event &event) {
+    switch (event.type) {
     case SDL_EVENT_WINDOW_RESIZED: {
         EventData data;
-        data.window.width = event->window.data1;
-        data.window.height = event->window.data2;
-        InvokeCallback(EventType::WindowResize, data);
+        data.window.width = event.window.data1;
+        data.window.height = event.window.data2;
+        Dispatch(EventType::WindowResize, data);
         return true;
     }
 
     case SDL_EVENT_KEY_DOWN: {
         EventData data;
-        data.keyboard.keycode = event->key.key;
-        data.keyboard.scancode = event->key.scancode;
-        data.keyboard.modifiers = event->key.mod;
-        InvokeCallback(EventType::KeyDown, data);
+        data.keyboard.keycode = event.key.key;
+        data.keyboard.scancode = event.key.scancode;
+        data.keyboard.modifiers = event.key.mod;
+        Dispatch(EventType::KeyDown, data);
         return true;
     }
 
     case SDL_EVENT_KEY_UP: {
         EventData data;
-        data.keyboard.keycode = event->key.key;
-        data.keyboard.scancode = event->key.scancode;
-        data.keyboard.modifiers = event->key.mod;
-        InvokeCallback(EventType::KeyUp, data);
+        data.keyboard.keycode = event.key.key;
+        data.keyboard.scancode = event.key.scancode;
+        data.keyboard.modifiers = event.key.mod;
+        Dispatch(EventType::KeyUp, data);
         return true;
     }
 
     case SDL_EVENT_MOUSE_BUTTON_DOWN: {
         EventData data;
-        data.mouse.x = event->button.x;
-        data.mouse.y = event->button.y;
-        data.mouse.button = event->button.button;
-        InvokeCallback(EventType::MouseButtonDown, data);
+        data.mouse.x = event.button.x;
+        data.mouse.y = event.button.y;
+        data.mouse.dx = 0.0f;
+        data.mouse.dy = 0.0f;
+        data.mouse.button = event.button.button;
+        Dispatch(EventType::MouseButtonDown, data);
         return true;
     }
 
     case SDL_EVENT_MOUSE_BUTTON_UP: {
         EventData data;
-        data.mouse.x = event->button.x;
-        data.mouse.y = event->button.y;
-        data.mouse.button = event->button.button;
-        InvokeCallback(EventType::MouseButtonUp, data);
+        data.mouse.x = event.button.x;
+        data.mouse.y = event.button.y;
+        data.mouse.dx = 0.0f;
+        data.mouse.dy = 0.0f;
+        data.mouse.button = event.button.button;
+        Dispatch(EventType::MouseButtonUp, data);
         return true;
     }
 
     case SDL_EVENT_MOUSE_MOTION: {
         EventData data;
-        data.mouse.x = event->motion.x;
-        data.mouse.y = event->motion.y;
-        InvokeCallback(EventType::MouseMove, data);
+        data.mouse.x = event.motion.x;
+        data.mouse.y = event.motion.y;
+        data.mouse.dx = event.motion.xrel;
+        data.mouse.dy = event.motion.yrel;
+        data.mouse.button = 0;
+        Dispatch(EventType::MouseMove, data);
         return true;
     }
 
     case SDL_EVENT_MOUSE_WHEEL: {
         EventData data;
-        data.mouse.x = event->wheel.x;
-        data.mouse.y = event->wheel.y;
-        InvokeCallback(EventType::MouseWheel, data);
+        data.mouse.x = event.wheel.x;
+        data.mouse.y = event.wheel.y;
+        data.mouse.dx = 0.0f;
+        data.mouse.dy = 0.0f;
+        data.mouse.button = 0;
+        Dispatch(EventType::MouseWheel, data);
         return true;
     }
     }
     return false;
 }
 
+void EventManager::Dispatch(EventType type, const EventData &data) {
+    auto policyIt = m_policies.find(type);
+    if (policyIt == m_policies.end() ||
+        policyIt->second == CoalescePolicy::Immediate) {
+        // keep ordering intact: merged motion that happened before a key or
+        // button press is delivered before it
+        DispatchCoalesced();
+        InvokeCallback(type, data);
+        return;
+    }
+
+    PendingEvent &pending = m_pending[type];
+    if (!pending.pending) {
+        pending.pending = true;
+        pending.data = data;
+        return;
+    }
+    switch (type) {
+    case EventType::MouseMove:
+        pending.data.mouse.x = data.mouse.x;
+        pending.data.mouse.y = data.mouse.y;
+        pending.data.mouse.dx += data.mouse.dx;
+        pending.data.mouse.dy += data.mouse.dy;
+        break;
+    case EventType::MouseWheel:
+        pending.data.mouse.x += data.mouse.x;
+        pending.data.mouse.y += data.mouse.y;
+        break;
+    default:
+        pending.data = data;
+        break;
+    }
+}
+
 void EventManager::InvokeCallback(EventType type, const EventData &data) {
     auto it = m_eventBindings.find(type);
     if (it != m_eventBindings.end()) {
-        for (EventCallback callback : it->second) {
-            callback(data);
+        // the binding list is left untouched until the outermost dispatch
+        // returns, removals only flip the slot's alive flag
+        m_dispatchDepth++;
+        for (uint32_t index : it->second) {
+            CallbackSlot &slot = m_slots[index];
+            if (slot.alive && slot.callback(data)) {
+                break;
+            }
         }
+        m_dispatchDepth--;
+    }
+    if (m_dispatchDepth == 0 &&
+        (!m_deadSlots.empty() || !m_pendingSlots.empty())) {
+        Compact();
     }
 }
 } // namespace Engine
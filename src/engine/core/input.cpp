@@ -0,0 +1,70 @@
+#include <climits>
+#include <engine/core/input.hpp>
+
+namespace Engine {
+namespace {
+// ahead of every game callback, so consuming callbacks cannot hide input
+constexpr int INPUT_PRIORITY = INT_MAX;
+} // namespace
+
+InputHandler::InputHandler(EventManager &events) : m_events(events) {
+    m_callbacks[0] = events.RegisterCallback(
+        EventType::KeyDown,
+        [this](const EventData &data) { OnKey(data, true); }, INPUT_PRIORITY);
+    m_callbacks[1] = events.RegisterCallback(
+        EventType::KeyUp,
+        [this](const EventData &data) { OnKey(data, false); }, INPUT_PRIORITY);
+    m_callbacks[2] = events.RegisterCallback(
+        EventType::MouseButtonDown,
+        [this](const EventData &data) { OnButton(data, true); },
+        INPUT_PRIORITY);
+    m_callbacks[3] = events.RegisterCallback(
+        EventType::MouseButtonUp,
+        [this](const EventData &data) { OnButton(data, false); },
+        INPUT_PRIORITY);
+    m_callbacks[4] = events.RegisterCallback(
+        EventType::MouseMove,
+        [this](const EventData &data) {
+            m_nextMousePosition = Vector2(data.mouse.x, data.mouse.y);
+        },
+        INPUT_PRIORITY);
+}
+
+// stale handles after EventManager::Shutdown are rejected, so this is safe
+// in either order
+InputHandler::~InputHandler() {
+    for (CallbackHandle handle : m_callbacks) {
+        m_events.DeregisterCallback(handle);
+    }
+}
+
+void InputHandler::OnKey(const EventData &data, bool down) {
+    SDL_Scancode key = data.keyboard.scancode;
+    if (key >= 0 && key < SDL_SCANCODE_COUNT) {
+        m_nextKeys[key] = down;
+    }
+}
+
+void InputHandler::OnButton(const EventData &data, bool down) {
+    m_nextMousePosition = Vector2(data.mouse.x, data.mouse.y);
+    if (data.mouse.button < 1 || data.mouse.button > 32) {
+        return;
+    }
+    SDL_MouseButtonFlags mask = SDL_BUTTON_MASK(data.mouse.button);
+    if (down) {
+        m_nextButtons |= mask;
+    } else {
+        m_nextButtons &= ~mask;
+    }
+}
+
+void InputHandler::Update() {
+    m_prevKeys = m_keys;
+    m_prevButtons = m_buttons;
+    m_prevMousePosition = m_mousePosition;
+
+    m_keys = m_nextKeys;
+    m_buttons = m_nextButtons;
+    m_mousePosition = m_nextMousePosition;
+}
+} // namespace Engine
@@ -1,17 +1,44 @@
 #include <SDL3/SDL_blendmode.h>
 #include <SDL3/SDL_render.h>
 #include <algorithm>
+#include <engine/core/commands.hpp>
 #include <engine/core/renderer.hpp>
+#include <engine/util/math.hpp>
+#include <engine/util/memory.hpp>
+#include <utility>
 
 namespace Engine {
+namespace {
+SDL_BlendMode ToSDLBlendMode(BlendMode blendMode) {
+    switch (blendMode) {
+    case BlendMode::None:
+        return SDL_BLENDMODE_NONE;
+    case BlendMode::Add:
+        return SDL_BLENDMODE_ADD;
+    case BlendMode::Multiply:
+        return SDL_BLENDMODE_MUL;
+    default:
+        return SDL_BLENDMODE_BLEND;
+    }
+}
+} // namespace
+
 Renderer::~Renderer() { Shutdown(); }
 bool Renderer::Init(Window &window) {
+    MemoryScope memoryScope(MemoryTag::Renderer);
     m_window = &window;
-    m_renderer = SDL_CreateRenderer(m_window->GetSDLWindow(), 0);
+    // there is no GPU behind the offscreen driver
+    const char *driver =
+        m_window->IsHeadless() ? SDL_SOFTWARE_RENDERER : nullptr;
+    m_renderer = SDL_CreateRenderer(m_window->GetSDLWindow(), driver);
     SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_BLEND);
     return m_renderer != nullptr;
 }
 void Renderer::Shutdown() {
+    if (m_retainedTarget != nullptr) {
+        SDL_DestroyTexture(m_retainedTarget);
+        m_retainedTarget = nullptr;
+    }
     if (m_renderer != nullptr) {
         SDL_DestroyRenderer(m_renderer);
         m_renderer = nullptr;
@@ -22,36 +49,135 @@ void Renderer::Clear(Color color) {
     SDL_RenderClear(m_renderer);
 }
 
-void Renderer::Present() { SDL_RenderPresent(m_renderer); }
+void Renderer::Present() {
+    SDL_RenderPresent(m_renderer);
+    m_frameStats = m_stats;
+    m_stats = RenderStats();
+}
 
 void Renderer::DrawPoint(Vector2 point) {
+    if (m_recording != nullptr) {
+        SDL_FPoint sdlPoint = point.ToSDLPoint();
+        m_recording->AddPoints(m_drawColor, m_currentBlendMode, &sdlPoint, 1);
+        return;
+    }
     SDL_SetRenderDrawColor(m_renderer, m_drawColor.r, m_drawColor.g,
                            m_drawColor.b, m_drawColor.a);
     SDL_RenderPoint(m_renderer, point.x, point.y);
+    m_stats.drawCalls++;
 }
 
 void Renderer::DrawLine(Vector2 pos1, Vector2 pos2) {
+    if (m_recording != nullptr) {
+        SDL_FPoint points[2] = {pos1.ToSDLPoint(), pos2.ToSDLPoint()};
+        m_recording->AddLines(m_drawColor, m_currentBlendMode, points, 2);
+        return;
+    }
     SDL_SetRenderDrawColor(m_renderer, m_drawColor.r, m_drawColor.g,
                            m_drawColor.b, m_drawColor.a);
     SDL_RenderLine(m_renderer, pos1.x, pos1.y, pos2.x, pos2.y);
+    m_stats.drawCalls++;
+}
+
+void Renderer::DrawLines(const SDL_FPoint *points, int count) {
+    if (m_recording != nullptr) {
+        m_recording->AddLines(m_drawColor, m_currentBlendMode, points, count);
+        return;
+    }
+    SDL_SetRenderDrawColor(m_renderer, m_drawColor.r, m_drawColor.g,
+                           m_drawColor.b, m_drawColor.a);
+    SDL_RenderLines(m_renderer, points, count);
+    m_stats.drawCalls++;
 }
 
 void Renderer::DrawRect(Rect rect) {
+    if (m_recording != nullptr) {
+        SDL_FRect frect = rect.ToSDLFRect();
+        m_recording->AddRects(m_drawColor, m_currentBlendMode, &frect, 1);
+        return;
+    }
     SDL_SetRenderDrawColor(m_renderer, m_drawColor.r, m_drawColor.g,
                            m_drawColor.b, m_drawColor.a);
     SDL_FRect frect = rect.ToSDLFRect();
     SDL_RenderRect(m_renderer, &frect);
+    m_stats.drawCalls++;
 }
 
 void Renderer::FillRect(Rect rect) {
+    if (m_recording != nullptr) {
+        // as geometry, so runs of fills and shapes merge into one call
+        SDL_FColor color = m_drawColor.ToSDLFColor();
+        float right = rect.x + rect.w;
+        float bottom = rect.y + rect.h;
+        SDL_Vertex vertices[4] = {{{rect.x, rect.y}, color, {0.0f, 0.0f}},
+                                  {{right, rect.y}, color, {0.0f, 0.0f}},
+                                  {{right, bottom}, color, {0.0f, 0.0f}},
+                                  {{rect.x, bottom}, color, {0.0f, 0.0f}}};
+        int indices[6] = {0, 1, 2, 0, 2, 3};
+        m_recording->AddGeometry(nullptr, m_currentBlendMode, vertices, 4,
+                                 indices, 6);
+        return;
+    }
     SDL_SetRenderDrawColor(m_renderer, m_drawColor.r, m_drawColor.g,
                            m_drawColor.b, m_drawColor.a);
     SDL_FRect frect = rect.ToSDLFRect();
     SDL_RenderFillRect(m_renderer, &frect);
+    m_stats.drawCalls++;
+}
+
+void Renderer::DrawGeometry(SDL_Texture *texture, const SDL_Vertex *vertices,
+                            int numVertices, const int *indices,
+                            int numIndices) {
+    if (m_recording != nullptr) {
+        m_recording->AddGeometry(texture, m_currentBlendMode, vertices,
+                                 numVertices, indices, numIndices);
+        return;
+    }
+    SDL_RenderGeometry(m_renderer, texture, vertices, numVertices, indices,
+                       numIndices);
+    m_stats.drawCalls++;
+    m_stats.vertices += numVertices;
+}
+
+void Renderer::DrawTextureRotated(SDL_Texture *texture,
+                                  const SDL_FRect *srcRect,
+                                  const SDL_FRect *dstRect, double angle,
+                                  const SDL_FPoint *center, SDL_FlipMode flip) {
+    if (m_recording != nullptr) {
+        RecordTexture(texture, srcRect, dstRect, angle, center, flip);
+        return;
+    }
+    SDL_RenderTextureRotated(m_renderer, texture, srcRect, dstRect, angle,
+                             center, flip);
+    m_stats.drawCalls++;
+    m_stats.vertices += 4;
+}
+
+void Renderer::DrawTexture(SDL_Texture *texture, const SDL_FRect *srcRect,
+                           const SDL_FRect *dstRect) {
+    if (m_recording != nullptr) {
+        RecordTexture(texture, srcRect, dstRect, 0.0, nullptr, SDL_FLIP_NONE);
+        return;
+    }
+    SDL_RenderTexture(m_renderer, texture, srcRect, dstRect);
+    m_stats.drawCalls++;
+    m_stats.vertices += 4;
+}
+
+void Renderer::DrawDebugText(Vector2 pos, const char *text) {
+    if (m_recording != nullptr) {
+        m_recording->AddText(m_drawColor, m_currentBlendMode, pos, text);
+        return;
+    }
+    SDL_RenderDebugText(m_renderer, pos.x, pos.y, text);
+    m_stats.drawCalls++;
 }
 
 void Renderer::SetDrawColor(Color color) {
     m_drawColor = color;
+    if (m_recording != nullptr) {
+        return;
+    }
     SDL_SetRenderDrawColor(m_renderer, m_drawColor.r, m_drawColor.g,
                            m_drawColor.b, m_drawColor.a);
 }
@@ -60,29 +186,22 @@ void Renderer::SetOpacity(float opacity) {
     m_opacity = std::clamp(opacity, 0.0f, 1.0f);
     uint8_t alpha = static_cast<uint8_t>(255.0f * m_opacity);
     m_drawColor.a = alpha;
+    if (m_recording != nullptr) {
+        return;
+    }
     SDL_SetRenderDrawColor(m_renderer, m_drawColor.r, m_drawColor.g,
                            m_drawColor.b, m_drawColor.a);
 }
 
 void Renderer::SetBlendMode(BlendMode blendMode) {
     m_currentBlendMode = blendMode;
-    switch (blendMode) {
-    case BlendMode::None:
-        SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_NONE);
-        break;
-    case BlendMode::Blend:
-        SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_BLEND);
-        break;
-    case BlendMode::Add:
-        SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_ADD);
-        break;
-    case BlendMode::Multiply:
-        SDL_SetRenderDrawBlendMode(m_renderer, SDL_BLENDMODE_MUL);
-        break;
+    if (m_recording == nullptr) {
+        SDL_SetRenderDrawBlendMode(m_renderer, ToSDLBlendMode(blendMode));
     }
 }
 
 void Renderer::PushBlendMode(BlendMode mode) {
+    MemoryScope memoryScope(MemoryTag::Renderer);
     m_blendModeStack.push_back(m_currentBlendMode);
     SetBlendMode(mode);
 }
@@ -94,6 +213,27 @@ void Renderer::PopBlendMode() {
     }
 }
 
+void Renderer::PushTransform(const Transform2D &transform) {
+    MemoryScope memoryScope(MemoryTag::Renderer);
+    m_transformStack.push_back(m_transform);
+    m_transform = m_transform * transform;
+}
+
+void Renderer::PopTransform() {
+    if (!m_transformStack.empty()) {
+        m_transform = m_transformStack.back();
+        m_transformStack.pop_back();
+    }
+}
+
+void Renderer::SetViewTransform(const Transform2D &view) {
+    if (!m_transformStack.empty()) {
+        return;
+    }
+    m_viewTransform = view;
+    m_transform = view;
+}
+
 void Renderer::SetViewport(Rect rect) {
     SDL_Rect viewport = rect.ToSDLRect();
     SDL_SetRenderViewport(m_renderer, &viewport);
@@ -101,4 +241,237 @@ void Renderer::SetViewport(Rect rect) {
 
 void Renderer::ResetViewport() { SDL_SetRenderViewport(m_renderer, 0); }
 
+void Renderer::SetClipRect(const Rect *rect) {
+    if (rect == nullptr) {
+        SDL_SetRenderClipRect(m_renderer, nullptr);
+        return;
+    }
+    SDL_Rect clip = rect->ToSDLRect();
+    SDL_SetRenderClipRect(m_renderer, &clip);
+}
+
+void Renderer::SetTarget(SDL_Texture *texture) {
+    SDL_SetRenderTarget(m_renderer, texture);
+}
+
+void Renderer::BeginRecording(RenderCommandList *commands) {
+    m_recording = commands;
+}
+
+// SDL_RenderTextureRotated's quad as geometry, so it sorts and merges with
+// sprites. Like the original it ignores the transform stack.
+void Renderer::RecordTexture(SDL_Texture *texture, const SDL_FRect *srcRect,
+                             const SDL_FRect *dstRect, double angle,
+                             const SDL_FPoint *center, SDL_FlipMode flip) {
+    if (texture == nullptr || texture->w <= 0 || texture->h <= 0) {
+        return;
+    }
+    float texWidth = static_cast<float>(texture->w);
+    float texHeight = static_cast<float>(texture->h);
+    SDL_FRect src = {0.0f, 0.0f, texWidth, texHeight};
+    if (srcRect != nullptr) {
+        src = *srcRect;
+    }
+    SDL_FRect dst;
+    if (dstRect != nullptr) {
+        dst = *dstRect;
+    } else {
+        int width = 0;
+        int height = 0;
+        SDL_GetCurrentRenderOutputSize(m_renderer, &width, &height);
+        dst = {0.0f, 0.0f, static_cast<float>(width),
+               static_cast<float>(height)};
+    }
+
+    Vector2 pivot(dst.w * 0.5f, dst.h * 0.5f);
+    if (center != nullptr) {
+        pivot = Vector2(center->x, center->y);
+    }
+    float sinTheta = 0.0f;
+    float cosTheta = 1.0f;
+    if (angle != 0.0) {
+        SinCosDegrees(static_cast<float>(angle), sinTheta, cosTheta);
+    }
+    Vector2 corners[4] = {Vector2(0.0f, 0.0f), Vector2(dst.w, 0.0f),
+                          Vector2(dst.w, dst.h), Vector2(0.0f, dst.h)};
+    for (Vector2 &corner : corners) {
+        Vector2 offset = corner - pivot;
+        corner = Vector2(
+            dst.x + pivot.x + offset.x * cosTheta - offset.y * sinTheta,
+            dst.y + pivot.y + offset.x * sinTheta + offset.y * cosTheta);
+    }
+
+    float u0 = src.x / texWidth;
+    float v0 = src.y / texHeight;
+    float u1 = (src.x + src.w) / texWidth;
+    float v1 = (src.y + src.h) / texHeight;
+    if (flip & SDL_FLIP_HORIZONTAL) {
+        std::swap(u0, u1);
+    }
+    if (flip & SDL_FLIP_VERTICAL) {
+        std::swap(v0, v1);
+    }
+    SDL_FColor white = {1.0f, 1.0f, 1.0f, 1.0f};
+    SDL_Vertex vertices[4] = {{corners[0].ToSDLPoint(), white, {u0, v0}},
+                              {corners[1].ToSDLPoint(), white, {u1, v0}},
+                              {corners[2].ToSDLPoint(), white, {u1, v1}},
+                              {corners[3].ToSDLPoint(), white, {u0, v1}}};
+    int indices[6] = {0, 1, 2, 0, 2, 3};
+    m_recording->AddGeometry(texture, m_currentBlendMode, vertices, 4, indices,
+                             6);
+}
+
+void Renderer::Submit(const RenderCommandList &list) {
+    MemoryScope memoryScope(MemoryTag::Renderer);
+    const std::vector<RenderCommand> &commands = list.GetCommands();
+    const std::vector<uint32_t> &order = list.GetOrder();
+    const SDL_Vertex *vertices = list.GetVertices().data();
+    const int *indices = list.GetIndices().data();
+    const SDL_FPoint *points = list.GetPoints().data();
+    const SDL_FRect *rects = list.GetRects().data();
+    const char *text = list.GetText().data();
+
+    // a list that was never sorted draws in the order it was recorded
+    bool sorted = order.size() == commands.size();
+    auto commandAt = [&](size_t i) -> const RenderCommand & {
+        return commands[sorted ? order[i] : i];
+    };
+    auto canMerge = [](const RenderCommand &a, const RenderCommand &b) {
+        if (a.type != b.type || a.blendMode != b.blendMode) {
+            return false;
+        }
+        switch (a.type) {
+        case RenderCommandType::Geometry:
+            return a.texture == b.texture;
+        case RenderCommandType::Points:
+        case RenderCommandType::Rects:
+            return a.color == b.color;
+        default:
+            // line strips would join up, text is one string per call
+            return false;
+        }
+    };
+
+    // SDL's state is only touched when a command needs something else
+    BlendMode blendMode = m_currentBlendMode;
+    Color color = m_drawColor;
+    size_t count = commands.size();
+    for (size_t i = 0; i < count;) {
+        const RenderCommand &command = commandAt(i);
+        size_t end = i + 1;
+        while (end < count && canMerge(command, commandAt(end))) {
+            end++;
+        }
+        if (command.blendMode != blendMode) {
+            blendMode = command.blendMode;
+            SDL_SetRenderDrawBlendMode(m_renderer, ToSDLBlendMode(blendMode));
+        }
+        if (command.type != RenderCommandType::Geometry &&
+            command.color != color) {
+            color = command.color;
+            SDL_SetRenderDrawColor(m_renderer, color.r, color.g, color.b,
+                                   color.a);
+        }
+
+        switch (command.type) {
+        case RenderCommandType::Geometry:
+            if (end == i + 1) {
+                SDL_RenderGeometry(m_renderer, command.texture,
+                                   vertices + command.first, command.count,
+                                   indices + command.firstIndex,
+                                   command.indexCount);
+                m_stats.vertices += command.count;
+                break;
+            }
+            m_batchVertices.clear();
+            m_batchIndices.clear();
+            for (size_t j = i; j < end; j++) {
+                const RenderCommand &part = commandAt(j);
+                int base = static_cast<int>(m_batchVertices.size());
+                m_batchVertices.insert(m_batchVertices.end(),
+                                       vertices + part.first,
+                                       vertices + part.first + part.count);
+                const int *partIndices = indices + part.firstIndex;
+                for (uint32_t k = 0; k < part.indexCount; k++) {
+                    m_batchIndices.push_back(base + partIndices[k]);
+                }
+            }
+            SDL_RenderGeometry(m_renderer, command.texture,
+                               m_batchVertices.data(),
+                               static_cast<int>(m_batchVertices.size()),
+                               m_batchIndices.data(),
+                               static_cast<int>(m_batchIndices.size()));
+            m_stats.vertices += static_cast<uint32_t>(m_batchVertices.size());
+            break;
+        case RenderCommandType::Lines:
+            SDL_RenderLines(m_renderer, points + command.first, command.count);
+            break;
+        case RenderCommandType::Points:
+            m_batchPoints.clear();
+            for (size_t j = i; j < end; j++) {
+                const RenderCommand &part = commandAt(j);
+                m_batchPoints.insert(m_batchPoints.end(), points + part.first,
+                                     points + part.first + part.count);
+            }
+            SDL_RenderPoints(m_renderer, m_batchPoints.data(),
+                             static_cast<int>(m_batchPoints.size()));
+            break;
+        case RenderCommandType::Rects:
+            m_batchRects.clear();
+            for (size_t j = i; j < end; j++) {
+                const RenderCommand &part = commandAt(j);
+                m_batchRects.insert(m_batchRects.end(), rects + part.first,
+                                    rects + part.first + part.count);
+            }
+            SDL_RenderRects(m_renderer, m_batchRects.data(),
+                            static_cast<int>(m_batchRects.size()));
+            break;
+        case RenderCommandType::Text:
+            SDL_RenderDebugText(m_renderer, points[command.first].x,
+                                points[command.first].y,
+                                text + command.firstIndex);
+            break;
+        }
+        m_stats.drawCalls++;
+        i = end;
+    }
+    m_stats.commands += static_cast<uint32_t>(count);
+
+    // back to what the state setters last asked for
+    if (blendMode != m_currentBlendMode) {
+        SDL_SetRenderDrawBlendMode(m_renderer,
+                                   ToSDLBlendMode(m_currentBlendMode));
+    }
+    if (color != m_drawColor) {
+        SDL_SetRenderDrawColor(m_renderer, m_drawColor.r, m_drawColor.g,
+                               m_drawColor.b, m_drawColor.a);
+    }
+}
+
+SDL_Texture *Renderer::GetRetainedTarget(bool &recreated) {
+    MemoryScope memoryScope(MemoryTag::Renderer);
+    recreated = false;
+    int width = 0;
+    int height = 0;
+    SDL_GetRenderOutputSize(m_renderer, &width, &height);
+    if (m_retainedTarget != nullptr && width == m_retainedWidth &&
+        height == m_retainedHeight) {
+        return m_retainedTarget;
+    }
+    if (m_retainedTarget != nullptr) {
+        SDL_DestroyTexture(m_retainedTarget);
+    }
+    m_retainedTarget =
+        SDL_CreateTexture(m_renderer, SDL_PIXELFORMAT_RGBA8888,
+                          SDL_TEXTUREACCESS_TARGET, width, height);
+    if (m_retainedTarget != nullptr) {
+        // copied over the window as is, alpha included
+        SDL_SetTextureBlendMode(m_retainedTarget, SDL_BLENDMODE_NONE);
+    }
+    m_retainedWidth = width;
+    m_retainedHeight = height;
+    recreated = true;
+    return m_retainedTarget;
+}
+
 } // namespace Engine
@@ -1,23 +1,56 @@
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_surface.h>
 #include <SDL3_image/SDL_image.h>
+#include <algorithm>
+#include <atomic>
 #include <engine/core/resource.hpp>
 #include <engine/core/texture.hpp>
+#include <engine/util/json.hpp>
+#include <engine/util/memory.hpp>
+#include <engine/util/startup.hpp>
 #include <memory>
 #include <string_view>
 namespace Engine {
+namespace {
+// decoding is mostly memory bound, more threads stop helping quickly
+constexpr unsigned MAX_PREFETCH_THREADS = 4;
+
+// Shared by the workers of one Prefetch call, each takes the next path
+struct PrefetchBatch {
+    std::vector<std::string> paths;
+    std::vector<std::promise<SDL_Surface *>> surfaces;
+    std::atomic<size_t> next{0};
+};
+
+void DestroySurface(std::future<SDL_Surface *> &surface) {
+    if (SDL_Surface *decoded = surface.get()) {
+        SDL_DestroySurface(decoded);
+    }
+}
+} // namespace
 
 ResourceManager::ResourceManager(Renderer &renderer) : m_renderer(renderer) {}
 
 ResourceManager::~ResourceManager() {
+    for (std::thread &worker : m_prefetchWorkers) {
+        worker.join();
+    }
+    for (auto &[path, surface] : m_prefetched) {
+        DestroySurface(surface);
+    }
     m_resourcePaths.clear();
     m_textureMap.clear();
 }
 
 void ResourceManager::AddResource(const std::string &path, ResourceType type) {
+    MemoryScope memoryScope(MemoryTag::ResourceManager);
     m_resourcePaths.emplace(path, type);
 }
 
 bool ResourceManager::RemoveResource(const std::string_view path,
                                      ResourceType type) {
+    MemoryScope memoryScope(MemoryTag::ResourceManager);
     auto it_resPath = m_resourcePaths.find(std::string(path));
     if (it_resPath == m_resourcePaths.end() || it_resPath->second != type) {
         return false;
@@ -25,6 +58,11 @@ bool ResourceManager::RemoveResource(const std::string_view path,
     m_resourcePaths.erase(it_resPath);
     switch (type) {
     case ResourceType::Texture: {
+        auto it_prefetch = m_prefetched.find(std::string(path));
+        if (it_prefetch != m_prefetched.end()) {
+            DestroySurface(it_prefetch->second);
+            m_prefetched.erase(it_prefetch);
+        }
         auto it_texcache = m_textureMap.find(path);
         if (it_texcache != m_textureMap.end()) {
             m_textureMap.erase(it_texcache);
@@ -38,30 +76,122 @@ bool ResourceManager::RemoveResource(const std::string_view path,
 
 std::shared_ptr<Texture>
 ResourceManager::FindTexture(const std::string_view path) {
+    MemoryScope memoryScope(MemoryTag::ResourceManager);
     auto it_tex = m_textureMap.find(path);
     auto it_res = m_resourcePaths.find(std::string(path));
     // if texture not loaded, and imported as asset and actually a texture
     if (it_tex == m_textureMap.end() && it_res != m_resourcePaths.end() &&
         it_res->second == ResourceType::Texture) {
         CreateTexture(path);
-        return FindTexture(path);
-    } else if (it_tex == m_textureMap.end()) {
+        // looked up once more rather than recursing, a file that fails to
+        // load would recurse forever
+        it_tex = m_textureMap.find(path);
+    }
+    if (it_tex == m_textureMap.end()) {
         return nullptr; // else if resource not loaded but not (a texture or
                         // imported as asset)
     }
     return it_tex->second;
 }
 
+bool ResourceManager::ReadManifest(std::string_view path,
+                                   std::vector<std::string> &textures,
+                                   std::string *error) {
+    size_t size = 0;
+    std::string pathString(path);
+    std::unique_ptr<char, decltype(&SDL_free)> data(
+        static_cast<char *>(SDL_LoadFile(pathString.c_str(), &size)),
+        &SDL_free);
+    if (data == nullptr) {
+        if (error != nullptr) {
+            *error = SDL_GetError();
+        }
+        return false;
+    }
+    JsonValue manifest;
+    if (!JsonValue::Parse(std::string_view(data.get(), size), manifest,
+                          error)) {
+        return false;
+    }
+    for (const JsonValue &texture : manifest["textures"].GetArray()) {
+        if (texture.AsString().empty()) {
+            if (error != nullptr) {
+                *error = "manifest textures must be non-empty strings";
+            }
+            return false;
+        }
+        textures.push_back(texture.AsString());
+    }
+    return true;
+}
+
+void ResourceManager::Prefetch(const std::vector<std::string> &paths) {
+    MemoryScope memoryScope(MemoryTag::ResourceManager);
+    auto batch = std::make_shared<PrefetchBatch>();
+    for (const std::string &path : paths) {
+        AddResource(path, ResourceType::Texture);
+        if (m_textureMap.count(path) > 0 || m_prefetched.count(path) > 0) {
+            continue;
+        }
+        batch->paths.push_back(path);
+        batch->surfaces.emplace_back();
+        m_prefetched.emplace(path, batch->surfaces.back().get_future());
+    }
+    if (batch->paths.empty()) {
+        return;
+    }
+
+    // SDL_image decodes to surfaces on any thread, only the upload to a
+    // texture has to wait for the main thread
+    unsigned cores = std::thread::hardware_concurrency();
+    size_t workers = std::min<size_t>(
+        {batch->paths.size(), cores > 1 ? cores - 1 : 1, MAX_PREFETCH_THREADS});
+    for (size_t i = 0; i < workers; i++) {
+        m_prefetchWorkers.emplace_back([batch]() {
+            Startup::StepScope step("texture_prefetch", false);
+            for (size_t index = batch->next++; index < batch->paths.size();
+                 index = batch->next++) {
+                batch->surfaces[index].set_value(
+                    IMG_Load(batch->paths[index].c_str()));
+            }
+        });
+    }
+}
+
 void ResourceManager::CreateTexture(const std::string_view path) {
     std::shared_ptr<Texture> texture = std::make_shared<Texture>();
-    SDL_Texture *sdlTex =
-        IMG_LoadTexture(m_renderer.GetSDLRenderer(), std::string(path).c_str());
+    SDL_Texture *sdlTex = nullptr;
+    auto it_prefetch = m_prefetched.find(std::string(path));
+    if (it_prefetch != m_prefetched.end()) {
+        SDL_Surface *surface = it_prefetch->second.get();
+        m_prefetched.erase(it_prefetch);
+        if (surface != nullptr) {
+            sdlTex = SDL_CreateTextureFromSurface(m_renderer.GetSDLRenderer(),
+                                                  surface);
+            SDL_DestroySurface(surface);
+        }
+    } else {
+        sdlTex = IMG_LoadTexture(m_renderer.GetSDLRenderer(),
+                                 std::string(path).c_str());
+    }
     if (sdlTex == nullptr) {
         // TODO: add logging here
         return;
     }
     texture->SetTexture(sdlTex);
-    m_textureMap.emplace(path, std::move(texture));
+    texture->SetPath(path);
+    // the map's key views the texture's own copy of the path, the caller's
+    // string may not outlive the cache. SetPath is private to keep it stable.
+    std::string_view key = texture->GetPath();
+    m_textureMap.emplace(key, std::move(texture));
+}
+
+size_t ResourceManager::GetTextureMemory() const {
+    size_t bytes = 0;
+    for (const auto &[path, texture] : m_textureMap) {
+        bytes += texture->GetMemoryBytes();
+    }
+    return bytes;
 }
 
 } // namespace Engine
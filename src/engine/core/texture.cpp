@@ -16,5 +16,11 @@ void Texture::SetTexture(SDL_Texture *texture) {
     m_texture = texture;
     m_width = m_texture->w;
     m_height = m_texture->h;
+    m_format = m_texture->format;
+}
+
+size_t Texture::GetMemoryBytes() const {
+    return static_cast<size_t>(m_width) * m_height *
+           SDL_BYTESPERPIXEL(m_format);
 }
 } // namespace Engine
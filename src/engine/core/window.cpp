@@ -1,3 +1,4 @@
+#include <SDL3/SDL_hints.h>
 #include <engine/core/window.hpp>
 
 namespace Engine {
@@ -7,6 +8,12 @@ bool Window::Init(const WindowProps &props) {
     m_title = props.title;
     m_width = props.width;
     m_height = props.height;
+    m_headless = props.headless;
+    if (m_headless) {
+        // must be set before the video subsystem is brought up by the first
+        // window creation
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+    }
     m_properties = SDL_CreateProperties();
     SDL_SetBooleanProperty(m_properties,
                            SDL_PROP_WINDOW_CREATE_RESIZABLE_BOOLEAN,
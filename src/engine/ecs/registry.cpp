@@ -0,0 +1,49 @@
+#include <engine/ecs/registry.hpp>
+
+namespace Engine {
+namespace Ecs {
+Entity Registry::Create() {
+    uint32_t index;
+    if (!m_freeIndices.empty()) {
+        index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_generations.size());
+        m_generations.push_back(1);
+    }
+    m_aliveCount++;
+    return {index, m_generations[index]};
+}
+
+void Registry::Destroy(Entity entity) {
+    if (!IsAlive(entity)) {
+        return;
+    }
+    for (auto &[type, set] : m_sets) {
+        set->Remove(entity.index);
+    }
+    uint32_t &generation = m_generations[entity.index];
+    // generation 0 marks an invalid entity, skip it on wrap
+    if (++generation == 0) {
+        generation = 1;
+    }
+    m_freeIndices.push_back(entity.index);
+    m_aliveCount--;
+}
+
+void Registry::Clear() {
+    for (auto &[type, set] : m_sets) {
+        set->Clear();
+    }
+    m_freeIndices.clear();
+    for (uint32_t index = 0; index < m_generations.size(); index++) {
+        uint32_t &generation = m_generations[index];
+        if (++generation == 0) {
+            generation = 1;
+        }
+        m_freeIndices.push_back(index);
+    }
+    m_aliveCount = 0;
+}
+} // namespace Ecs
+} // namespace Engine
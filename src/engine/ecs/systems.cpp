@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <engine/core/renderer.hpp>
+#include <engine/core/texture.hpp>
+#include <engine/ecs/systems.hpp>
+#include <engine/util/math.hpp>
+#include <engine/util/transform.hpp>
+
+namespace Engine {
+namespace Ecs {
+namespace {
+constexpr int CIRCLE_SEGMENTS = 24;
+// flush before a batch outgrows this, keeps the buffers bounded
+constexpr size_t MAX_BATCH_VERTICES = 65536;
+
+struct UnitCircle {
+    Vector2 points[CIRCLE_SEGMENTS];
+    UnitCircle() {
+        for (int i = 0; i < CIRCLE_SEGMENTS; i++) {
+            float degrees = 360.0f * i / CIRCLE_SEGMENTS;
+            SinCosDegrees(degrees, points[i].y, points[i].x);
+        }
+    }
+};
+const UnitCircle s_unitCircle;
+
+uint64_t CellKey(int32_t x, int32_t y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+           static_cast<uint32_t>(y);
+}
+
+Transform2D WorldTransform(const Transform2D &view,
+                           const Transform &transform) {
+    float sinTheta = 0.0f;
+    float cosTheta = 1.0f;
+    if (transform.rotation != 0.0f) {
+        FastSinCosDegrees(transform.rotation, sinTheta, cosTheta);
+    }
+    return view * Transform2D::FromTRS(transform.position, sinTheta, cosTheta,
+                                       transform.scale);
+}
+} // namespace
+
+void UpdateMovement(Registry &registry, float dt) {
+    registry.Each<Velocity, Transform>(
+        [dt](Entity, const Velocity &velocity, Transform &transform) {
+            transform.position = transform.position + velocity.linear * dt;
+            transform.rotation += velocity.angular * dt;
+        });
+}
+
+void CollisionSystem::Update(Registry &registry) {
+    m_boxes.clear();
+    m_entries.clear();
+    m_pairs.clear();
+    if (m_cellSize <= 0.0f) {
+        return;
+    }
+
+    float invCell = 1.0f / m_cellSize;
+    registry.Each<Collider, Transform>([&](Entity entity,
+                                           const Collider &collider,
+                                           const Transform &transform) {
+        Box box;
+        box.entity = entity;
+        box.bounds = collider.bounds;
+        box.bounds.x += transform.position.x;
+        box.bounds.y += transform.position.y;
+        box.layer = collider.layer;
+        box.mask = collider.mask;
+        box.minX = static_cast<int32_t>(SDL_floorf(box.bounds.x * invCell));
+        box.minY = static_cast<int32_t>(SDL_floorf(box.bounds.y * invCell));
+        box.maxX = static_cast<int32_t>(
+            SDL_floorf((box.bounds.x + box.bounds.w) * invCell));
+        box.maxY = static_cast<int32_t>(
+            SDL_floorf((box.bounds.y + box.bounds.h) * invCell));
+        m_boxes.push_back(box);
+    });
+
+    for (uint32_t i = 0; i < m_boxes.size(); i++) {
+        const Box &box = m_boxes[i];
+        for (int32_t y = box.minY; y <= box.maxY; y++) {
+            for (int32_t x = box.minX; x <= box.maxX; x++) {
+                m_entries.push_back({CellKey(x, y), i});
+            }
+        }
+    }
+    std::sort(m_entries.begin(), m_entries.end(),
+              [](const CellEntry &lhs, const CellEntry &rhs) {
+                  return lhs.cell < rhs.cell ||
+                         (lhs.cell == rhs.cell && lhs.box < rhs.box);
+              });
+
+    size_t runStart = 0;
+    while (runStart < m_entries.size()) {
+        size_t runEnd = runStart + 1;
+        while (runEnd < m_entries.size() &&
+               m_entries[runEnd].cell == m_entries[runStart].cell) {
+            runEnd++;
+        }
+        uint64_t cell = m_entries[runStart].cell;
+        for (size_t i = runStart; i < runEnd; i++) {
+            const Box &a = m_boxes[m_entries[i].box];
+            for (size_t j = i + 1; j < runEnd; j++) {
+                const Box &b = m_boxes[m_entries[j].box];
+                if (!(a.layer & b.mask) || !(b.layer & a.mask) ||
+                    !a.bounds.Intersects(b.bounds)) {
+                    continue;
+                }
+                // boxes sharing several cells are only reported from the
+                // first cell of their overlap
+                if (CellKey(std::max(a.minX, b.minX),
+                            std::max(a.minY, b.minY)) != cell) {
+                    continue;
+                }
+                m_pairs.push_back({a.entity, b.entity});
+            }
+        }
+        runStart = runEnd;
+    }
+}
+
+RenderSystem::RenderSystem() {
+    m_vertices.reserve(1024);
+    m_indices.reserve(1536);
+}
+
+void RenderSystem::Flush(Renderer &renderer, SDL_Texture *texture) {
+    if (!m_vertices.empty()) {
+        renderer.DrawGeometry(texture, m_vertices.data(),
+                              static_cast<int>(m_vertices.size()),
+                              m_indices.data(),
+                              static_cast<int>(m_indices.size()));
+    }
+    m_vertices.clear();
+    m_indices.clear();
+}
+
+void RenderSystem::Render(Registry &registry, Renderer &renderer) {
+    const Transform2D &view = renderer.GetTransform();
+
+    registry.Each<Shape, Transform>([&](Entity, const Shape &shape,
+                                        const Transform &transform) {
+        if (m_vertices.size() + CIRCLE_SEGMENTS + 1 > MAX_BATCH_VERTICES) {
+            Flush(renderer, nullptr);
+        }
+        Transform2D world = WorldTransform(view, transform);
+        SDL_FColor color = shape.color.ToSDLFColor();
+        int base = static_cast<int>(m_vertices.size());
+        if (shape.type == ShapeType::Circle) {
+            float radius = shape.size.x;
+            m_vertices.push_back(
+                {world.Apply(Vector2()).ToSDLPoint(), color, {0.0f, 0.0f}});
+            for (int i = 0; i < CIRCLE_SEGMENTS; i++) {
+                Vector2 rim = s_unitCircle.points[i] * radius;
+                m_vertices.push_back(
+                    {world.Apply(rim).ToSDLPoint(), color, {0.0f, 0.0f}});
+                int next = (i + 1) % CIRCLE_SEGMENTS;
+                m_indices.push_back(base);
+                m_indices.push_back(base + 1 + i);
+                m_indices.push_back(base + 1 + next);
+            }
+            return;
+        }
+        float halfW = shape.size.x * 0.5f;
+        float halfH = shape.size.y * 0.5f;
+        Vector2 corners[4] = {Vector2(-halfW, -halfH), Vector2(halfW, -halfH),
+                              Vector2(halfW, halfH), Vector2(-halfW, halfH)};
+        for (const Vector2 &corner : corners) {
+            m_vertices.push_back(
+                {world.Apply(corner).ToSDLPoint(), color, {0.0f, 0.0f}});
+        }
+        for (int index : {0, 1, 2, 0, 2, 3}) {
+            m_indices.push_back(base + index);
+        }
+    });
+    Flush(renderer, nullptr);
+
+    SDL_Texture *batchTexture = nullptr;
+    registry.Each<SpriteRef, Transform>([&](Entity, const SpriteRef &sprite,
+                                            const Transform &transform) {
+        if (!sprite.texture || sprite.texture->GetSDLTexture() == nullptr) {
+            return;
+        }
+        SDL_Texture *texture = sprite.texture->GetSDLTexture();
+        if (texture != batchTexture ||
+            m_vertices.size() + 4 > MAX_BATCH_VERTICES) {
+            Flush(renderer, batchTexture);
+            batchTexture = texture;
+        }
+
+        float texW = static_cast<float>(sprite.texture->GetWidth());
+        float texH = static_cast<float>(sprite.texture->GetHeight());
+        Rect source = sprite.source;
+        if (source.w <= 0.0f || source.h <= 0.0f) {
+            source = Rect(0.0f, 0.0f, texW, texH);
+        }
+        Vector2 size = sprite.size;
+        if (size.x <= 0.0f || size.y <= 0.0f) {
+            size = Vector2(source.w, source.h);
+        }
+        float u0 = source.x / texW, v0 = source.y / texH;
+        float u1 = (source.x + source.w) / texW;
+        float v1 = (source.y + source.h) / texH;
+
+        Transform2D world = WorldTransform(view, transform);
+        SDL_FColor color = sprite.tint.ToSDLFColor();
+        float halfW = size.x * 0.5f;
+        float halfH = size.y * 0.5f;
+        int base = static_cast<int>(m_vertices.size());
+        m_vertices.push_back({world.Apply(Vector2(-halfW, -halfH)).ToSDLPoint(),
+                              color,
+                              {u0, v0}});
+        m_vertices.push_back({world.Apply(Vector2(halfW, -halfH)).ToSDLPoint(),
+                              color,
+                              {u1, v0}});
+        m_vertices.push_back({world.Apply(Vector2(halfW, halfH)).ToSDLPoint(),
+                              color,
+                              {u1, v1}});
+        m_vertices.push_back({world.Apply(Vector2(-halfW, halfH)).ToSDLPoint(),
+                              color,
+                              {u0, v1}});
+        for (int index : {0, 1, 2, 0, 2, 3}) {
+            m_indices.push_back(base + index);
+        }
+    });
+    Flush(renderer, batchTexture);
+}
+} // namespace Ecs
+} // namespace Engine
@@ -1,9 +1,15 @@
 #include "engine/core/resource.hpp"
+#include <SDL3/SDL_error.h>
 #include <engine/core/event.hpp>
+#include <engine/core/input.hpp>
 #include <engine/core/renderer.hpp>
 #include <engine/core/window.hpp>
 #include <engine/engine.hpp>
+#include <engine/util/startup.hpp>
+#include <future>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace Engine {
 Engine &Engine::Instance() {
@@ -13,32 +19,98 @@ Engine &Engine::Instance() {
 
 Engine::~Engine() { Shutdown(); }
 
-bool Engine::Init() {
+bool Engine::Init(const WindowProps &windowProps,
+                  std::string_view manifestPath) {
     if (m_initialized) {
         return true;
     }
+    Startup::StepScope initStep("engine_init");
+
+    // Reading the manifest only touches the file system, so it overlaps
+    // creating the window and renderer, which have to stay on this thread.
+    std::vector<std::string> prefetchPaths;
+    std::string manifestError;
+    std::future<bool> manifest;
+    if (!manifestPath.empty()) {
+        manifest = std::async(
+            std::launch::async,
+            [path = std::string(manifestPath), &prefetchPaths,
+             &manifestError]() {
+                Startup::StepScope step("manifest", false);
+                return ResourceManager::ReadManifest(path, prefetchPaths,
+                                                     &manifestError);
+            });
+    }
+
     m_window = std::make_unique<Window>();
     m_renderer = std::make_unique<Renderer>();
-    if (!m_window->Init()) {
-        return false;
+    {
+        Startup::StepScope step("window");
+        if (!m_window->Init(windowProps)) {
+            return false;
+        }
     }
-    if (!m_renderer->Init(*m_window)) {
-        return false;
+    {
+        Startup::StepScope step("renderer");
+        if (!m_renderer->Init(*m_window)) {
+            return false;
+        }
     }
-    // TODO: Impl other subsystems here
-    m_eventHandler = std::make_unique<EventManager>();
-    m_renderManager = std::make_unique<RenderManager>();
-    m_resManager = std::make_unique<ResourceManager>(*m_renderer);
+    {
+        Startup::StepScope step("managers");
+        // TODO: Impl other subsystems here
+        m_eventHandler = std::make_unique<EventManager>();
+        m_animator = std::make_unique<Animator>();
+        m_renderManager = std::make_unique<RenderManager>();
+        m_resManager = std::make_unique<ResourceManager>(*m_renderer);
+        m_inputHandler = std::make_unique<InputHandler>(*m_eventHandler);
+        m_debugDraw = std::make_unique<DebugDraw>();
+    }
+
+    if (manifest.valid()) {
+        if (!manifest.get()) {
+            SDL_SetError("Asset manifest %s: %s",
+                         std::string(manifestPath).c_str(),
+                         manifestError.c_str());
+            return false;
+        }
+        // decoding continues in the background while the game sets up
+        m_resManager->Prefetch(prefetchPaths);
+    }
+    m_initialized = true;
     return true;
 }
 
+// Init may have failed part way, so only what was created is shut down
 void Engine::Shutdown() {
-    m_renderer->Shutdown();
-    m_window->Shutdown();
-    m_eventHandler->Shutdown();
+    if (m_renderer) {
+        m_renderer->Shutdown();
+    }
+    if (m_window) {
+        m_window->Shutdown();
+    }
+    if (m_eventHandler) {
+        m_eventHandler->Shutdown();
+    }
     m_initialized = false;
 }
 
+void Engine::BeginFrame() {
+    Memory::BeginFrame();
+    if (m_frameArena) {
+        m_frameArena->release();
+    }
+}
+
+std::pmr::memory_resource *Engine::GetFrameAllocator() {
+    if (!m_frameArena) {
+        m_frameBuffer = std::make_unique<std::byte[]>(FRAME_ARENA_SIZE);
+        m_frameArena = std::make_unique<std::pmr::monotonic_buffer_resource>(
+            m_frameBuffer.get(), FRAME_ARENA_SIZE);
+    }
+    return m_frameArena.get();
+}
+
 Window &Engine::GetWindow() { return *m_window; }
 
 Renderer &Engine::GetRenderer() { return *m_renderer; }
@@ -47,5 +119,11 @@ EventManager &Engine::GetEvents() { return *m_eventHandler; }
 
 RenderManager &Engine::GetRenderManager() { return *m_renderManager; }
 
+InputHandler &Engine::GetInputs() { return *m_inputHandler; }
+
+DebugDraw &Engine::GetDebugDraw() { return *m_debugDraw; }
+
+Animator &Engine::GetAnimator() { return *m_animator; }
+
 ResourceManager &Engine::GetResources() { return *m_resManager; };
 } // namespace Engine
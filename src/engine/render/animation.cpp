@@ -0,0 +1,193 @@
+#include <engine/render/animation.hpp>
+#include <utility>
+
+namespace Engine {
+AnimationClip::AnimationClip(std::string_view name,
+                             std::vector<AnimationFrame> frames,
+                             LoopMode loopMode)
+    : m_name(name), m_frames(std::move(frames)), m_loopMode(loopMode) {
+    for (const AnimationFrame &frame : m_frames) {
+        m_duration += frame.duration;
+    }
+}
+
+std::shared_ptr<const AnimationClip>
+AnimationClip::FromGrid(std::string_view name, Vector2 frameSize, int columns,
+                        int frameCount, float frameDuration, LoopMode loopMode,
+                        Vector2 origin) {
+    std::vector<AnimationFrame> frames;
+    frames.reserve(frameCount);
+    for (int i = 0; i < frameCount; i++) {
+        float x = origin.x + (i % columns) * frameSize.x;
+        float y = origin.y + (i / columns) * frameSize.y;
+        frames.push_back(
+            {Rect(x, y, frameSize.x, frameSize.y), frameDuration});
+    }
+    return std::make_shared<const AnimationClip>(name, std::move(frames),
+                                                 loopMode);
+}
+
+AnimationHandle Animator::Add(Sprite *sprite) {
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    m_slots[slot].state = static_cast<uint32_t>(m_states.size());
+
+    State state;
+    state.sprite = sprite;
+    state.slot = slot;
+    m_states.push_back(state);
+    m_clips.emplace_back();
+    return {slot, m_slots[slot].generation};
+}
+
+void Animator::Remove(AnimationHandle handle) {
+    if (Find(handle) == nullptr) {
+        return;
+    }
+    // swap the last state into the hole so the array stays packed
+    uint32_t index = m_slots[handle.index].state;
+    uint32_t last = static_cast<uint32_t>(m_states.size() - 1);
+    if (index != last) {
+        m_states[index] = m_states[last];
+        m_clips[index] = std::move(m_clips[last]);
+        m_slots[m_states[index].slot].state = index;
+    }
+    m_states.pop_back();
+    m_clips.pop_back();
+
+    Slot &slot = m_slots[handle.index];
+    // generation 0 marks an invalid handle, skip it on wrap
+    if (++slot.generation == 0) {
+        slot.generation = 1;
+    }
+    m_freeSlots.push_back(handle.index);
+}
+
+Animator::State *Animator::Find(AnimationHandle handle) {
+    if (handle.index >= m_slots.size() ||
+        m_slots[handle.index].generation != handle.generation) {
+        return nullptr;
+    }
+    return &m_states[m_slots[handle.index].state];
+}
+
+const Animator::State *Animator::Find(AnimationHandle handle) const {
+    if (handle.index >= m_slots.size() ||
+        m_slots[handle.index].generation != handle.generation) {
+        return nullptr;
+    }
+    return &m_states[m_slots[handle.index].state];
+}
+
+void Animator::Play(AnimationHandle handle,
+                    std::shared_ptr<const AnimationClip> clip, bool restart) {
+    State *state = Find(handle);
+    if (state == nullptr) {
+        return;
+    }
+    bool sameClip = state->clip == clip.get();
+    state->clip = clip.get();
+    state->playing = clip && clip->GetFrameCount() > 0;
+    if (restart || !sameClip) {
+        state->time = 0.0f;
+        state->frame = 0;
+        state->direction = 1;
+    }
+    if (state->playing) {
+        state->sprite->SetSourceRect(clip->GetFrames()[state->frame].source);
+    }
+    m_clips[m_slots[handle.index].state] = std::move(clip);
+}
+
+void Animator::Stop(AnimationHandle handle) {
+    if (State *state = Find(handle)) {
+        state->playing = false;
+        state->time = 0.0f;
+        state->frame = 0;
+        state->direction = 1;
+    }
+}
+
+void Animator::SetPaused(AnimationHandle handle, bool paused) {
+    State *state = Find(handle);
+    if (state != nullptr && state->clip != nullptr) {
+        state->playing = !paused;
+    }
+}
+
+void Animator::SetSpeed(AnimationHandle handle, float speed) {
+    if (State *state = Find(handle)) {
+        state->speed = speed;
+    }
+}
+
+bool Animator::IsPlaying(AnimationHandle handle) const {
+    const State *state = Find(handle);
+    return state != nullptr && state->playing;
+}
+
+int Animator::GetFrame(AnimationHandle handle) const {
+    const State *state = Find(handle);
+    return state != nullptr ? state->frame : 0;
+}
+
+void Animator::Update(float dt) {
+    for (State &state : m_states) {
+        if (state.playing) {
+            Advance(state, dt);
+        }
+    }
+}
+
+void Animator::Advance(State &state, float dt) {
+    const AnimationClip &clip = *state.clip;
+    if (clip.GetDuration() <= 0.0f) {
+        return;
+    }
+    const std::vector<AnimationFrame> &frames = clip.GetFrames();
+    int lastFrame = clip.GetFrameCount() - 1;
+    int startFrame = state.frame;
+
+    state.time += dt * state.speed;
+    while (state.time >= frames[state.frame].duration) {
+        state.time -= frames[state.frame].duration;
+        int next = state.frame + state.direction;
+        if (next >= 0 && next <= lastFrame) {
+            state.frame = next;
+            continue;
+        }
+        if (clip.GetLoopMode() == LoopMode::Once) {
+            state.playing = false;
+            state.time = 0.0f;
+            break;
+        } else if (clip.GetLoopMode() == LoopMode::Loop) {
+            state.frame = 0;
+        } else if (lastFrame > 0) {
+            state.direction = -state.direction;
+            state.frame += state.direction;
+        }
+    }
+
+    if (state.frame != startFrame) {
+        state.sprite->SetSourceRect(frames[state.frame].source);
+    }
+}
+
+AnimatedSprite::AnimatedSprite(Animator &animator,
+                               std::shared_ptr<Texture> texture, Vector2 pos)
+    : Sprite(std::move(texture), pos), m_animator(&animator),
+      m_handle(animator.Add(this)) {}
+
+AnimatedSprite::~AnimatedSprite() { m_animator->Remove(m_handle); }
+
+void AnimatedSprite::Play(std::shared_ptr<const AnimationClip> clip,
+                          bool restart) {
+    m_animator->Play(m_handle, std::move(clip), restart);
+}
+} // namespace Engine
@@ -0,0 +1,23 @@
+#include <engine/render/camera.hpp>
+
+namespace Engine {
+Transform2D Camera2D::GetViewTransform(Vector2 parallax) const {
+    Vector2 center(m_viewportSize.x * 0.5f, m_viewportSize.y * 0.5f);
+    Vector2 offset(-m_position.x * parallax.x, -m_position.y * parallax.y);
+    return Transform2D::FromTRS(center, -m_rotation, Vector2(m_zoom, m_zoom)) *
+           Transform2D::Translation(offset);
+}
+
+Rect Camera2D::GetWorldBounds() const {
+    Rect viewport(0.0f, 0.0f, m_viewportSize.x, m_viewportSize.y);
+    return GetViewTransform().Inverse().ApplyBounds(viewport);
+}
+
+Vector2 Camera2D::WorldToScreen(Vector2 world) const {
+    return GetViewTransform().Apply(world);
+}
+
+Vector2 Camera2D::ScreenToWorld(Vector2 screen) const {
+    return GetViewTransform().Inverse().Apply(screen);
+}
+} // namespace Engine
@@ -1,8 +1,49 @@
 #include "engine/util/vec2.hpp"
+#include <array>
 #include <engine/core/renderer.hpp>
 #include <engine/render/renderable.hpp>
 
 namespace Engine {
+namespace {
+constexpr int MIN_SEGMENTS = 8;
+constexpr int MAX_SEGMENTS = 128;
+constexpr int SEGMENT_STEP = 4;
+constexpr int TABLE_COUNT = (MAX_SEGMENTS - MIN_SEGMENTS) / SEGMENT_STEP + 1;
+// maximum distance between the true circle and its polygon, in pixels
+constexpr float MAX_CHORD_ERROR = 0.25f;
+
+// Unit circle points, shared by every circle using the same segment count.
+const std::vector<Vector2> &UnitCircle(int segments) {
+    static std::array<std::vector<Vector2>, TABLE_COUNT> tables;
+    std::vector<Vector2> &table =
+        tables[(segments - MIN_SEGMENTS) / SEGMENT_STEP];
+    if (table.empty()) {
+        table.reserve(segments);
+        for (int i = 0; i < segments; i++) {
+            float angle = (i * 2.0f * SDL_PI_F) / segments;
+            table.push_back(Vector2(SDL_cosf(angle), SDL_sinf(angle)));
+        }
+    }
+    return table;
+}
+
+// Triangle fan around vertex 0, shared like the unit circles.
+const std::vector<int> &FanIndices(int segments) {
+    static std::array<std::vector<int>, TABLE_COUNT> tables;
+    std::vector<int> &indices =
+        tables[(segments - MIN_SEGMENTS) / SEGMENT_STEP];
+    if (indices.empty()) {
+        indices.reserve(segments * 3);
+        for (int i = 1; i <= segments; i++) {
+            indices.push_back(0);
+            indices.push_back(i);
+            indices.push_back(i < segments ? i + 1 : 1);
+        }
+    }
+    return indices;
+}
+} // namespace
+
 CircleShape::CircleShape(Vector2 pos, float radius, Color color, bool filled) {
     m_filled = filled;
     m_radius = radius;
@@ -11,87 +52,86 @@ CircleShape::CircleShape(Vector2 pos, float radius, Color color, bool filled) {
     SetPivot(Vector2(0.5f, 0.5f));
 }
 
+int CircleShape::SegmentsForRadius(float screenRadius) {
+    if (screenRadius <= MAX_CHORD_ERROR * 2.0f) {
+        return MIN_SEGMENTS;
+    }
+    // a chord over angle t misses the arc by r * (1 - cos(t / 2))
+    float halfAngle = SDL_acosf(1.0f - MAX_CHORD_ERROR / screenRadius);
+    int segments = static_cast<int>(SDL_ceilf(SDL_PI_F / halfAngle));
+    segments = (segments + SEGMENT_STEP - 1) / SEGMENT_STEP * SEGMENT_STEP;
+    return SDL_clamp(segments, MIN_SEGMENTS, MAX_SEGMENTS);
+}
+
 void CircleShape::Render(Renderer &renderer) {
     if (!m_visible) {
         return;
     }
 
-    const int CIRCLE_SEGMENTS = 36;
     renderer.SetDrawColor(m_color);
 
-    std::vector<Vector2> perimeterPoints = GetCirclePoints(CIRCLE_SEGMENTS);
-
-    if (m_filled) {
-        std::vector<SDL_Vertex> vertices;
-        vertices.reserve(CIRCLE_SEGMENTS + 2);
-
-        SDL_FColor color = m_color.ToSDLFColor();
-
-        Vector2 center = TransformPoint(0, 0);
-        vertices.push_back({center.ToSDLPoint(), color, {0.5f, 0.5f}});
+    Transform2D transform = renderer.GetTransform() * GetLocalTransform();
+    Vector2 scale = transform.GetScale();
+    int segments = SegmentsForRadius(m_radius * SDL_max(scale.x, scale.y));
 
-        for (const Vector2 &point : perimeterPoints) {
-            float normalizedX =
-                (point.x - center.x) / (m_radius * m_scale.x) * 0.5f + 0.5f;
-            float normalizedY =
-                (point.y - center.y) / (m_radius * m_scale.y) * 0.5f + 0.5f;
-            vertices.push_back(
-                {point.ToSDLPoint(), color, {normalizedX, normalizedY}});
-        }
-
-        std::vector<int> indices;
-        indices.reserve(CIRCLE_SEGMENTS * 3);
-
-        for (int i = 1; i <= CIRCLE_SEGMENTS; i++) {
-            indices.push_back(0);
-            indices.push_back(i);
-            indices.push_back(i < CIRCLE_SEGMENTS ? i + 1 : 1);
-        }
+    if (segments != m_cachedSegments || m_color != m_cachedColor) {
+        UpdateGeometry(segments);
+    }
+    // the pivot cancels out for circles, they always rotate and scale around
+    // their center
+    Transform2D circleTransform =
+        transform * Transform2D::Scaling(Vector2(m_radius, m_radius));
+    if (!m_positionsValid || circleTransform != m_cachedTransform) {
+        UpdatePositions(circleTransform);
+    }
 
-        SDL_RenderGeometry(renderer.GetSDLRenderer(), nullptr, vertices.data(),
-                           vertices.size(), indices.data(), indices.size());
+    if (m_filled) {
+        const std::vector<int> &indices = FanIndices(segments);
+        renderer.DrawGeometry(nullptr, m_vertices.data(), m_vertices.size(),
+                              indices.data(), indices.size());
     } else {
-        for (int i = 0; i < CIRCLE_SEGMENTS; i++) {
-            int nextIdx = (i + 1) % CIRCLE_SEGMENTS;
-            renderer.DrawLine(perimeterPoints[i], perimeterPoints[nextIdx]);
-        }
+        renderer.DrawLines(m_outline.data(), m_outline.size());
     }
 }
 
-Vector2 CircleShape::TransformPoint(float x, float y) const {
-    float rotationRad = m_rotation * (M_PI / 180.0f);
-    float sinAngle = SDL_sinf(rotationRad);
-    float cosAngle = SDL_cosf(rotationRad);
-
-    float pivotOffsetX = 2 * m_radius * m_scale.x * m_pivot.x;
-    float pivotOffsetY = 2 * m_radius * m_scale.y * m_pivot.y;
-
-    float scaledX = x * m_scale.x;
-    float scaledY = y * m_scale.y;
-
-    scaledX -= pivotOffsetX;
-    scaledY -= pivotOffsetY;
-
-    float rotX = scaledX * cosAngle - scaledY * sinAngle;
-    float rotY = scaledX * sinAngle + scaledY * cosAngle;
-
-    float adjustedPivotX = pivotOffsetX * cosAngle - pivotOffsetY * sinAngle;
-    float adjustedPivotY = pivotOffsetX * sinAngle + pivotOffsetY * cosAngle;
+// Vertex colors and texture coordinates, which only depend on the segment
+// count and color. Both buffers are kept so toggling SetFilled needs no
+// rebuild, their capacity is reused across rebuilds.
+void CircleShape::UpdateGeometry(int segments) {
+    const std::vector<Vector2> &unit = UnitCircle(segments);
+    SDL_FColor color = m_color.ToSDLFColor();
+    m_vertices.resize(segments + 1);
+    m_vertices[0].color = color;
+    m_vertices[0].tex_coord = {0.5f, 0.5f};
+    for (int i = 0; i < segments; i++) {
+        m_vertices[i + 1].color = color;
+        m_vertices[i + 1].tex_coord = {unit[i].x * 0.5f + 0.5f,
+                                       unit[i].y * 0.5f + 0.5f};
+    }
+    m_outline.resize(segments + 1);
 
-    return Vector2(m_position.x + rotX + adjustedPivotX,
-                   m_position.y + rotY + adjustedPivotY);
+    m_cachedColor = m_color;
+    m_cachedSegments = segments;
+    m_positionsValid = false;
 }
 
-std::vector<Vector2> CircleShape::GetCirclePoints(int segments) const {
-    std::vector<Vector2> points;
-    points.reserve(segments);
+// Maps the shared unit circle to the screen with the batch kernel, the only
+// per circle work when the camera, layer or view changes.
+void CircleShape::UpdatePositions(const Transform2D &circleTransform) {
+    int segments = m_cachedSegments;
+    const std::vector<Vector2> &unit = UnitCircle(segments);
+    m_points.resize(segments);
+    TransformPoints(circleTransform, unit.data(), m_points.data(), segments);
 
+    m_vertices[0].position = circleTransform.GetTranslation().ToSDLPoint();
     for (int i = 0; i < segments; i++) {
-        float angle = (i * 2.0f * M_PI) / segments;
-        points.push_back(TransformPoint(SDL_cosf(angle) * m_radius,
-                                        SDL_sinf(angle) * m_radius));
+        SDL_FPoint point = m_points[i].ToSDLPoint();
+        m_vertices[i + 1].position = point;
+        m_outline[i] = point;
     }
+    m_outline[segments] = m_outline[0];
 
-    return points;
+    m_cachedTransform = circleTransform;
+    m_positionsValid = true;
 }
 } // namespace Engine
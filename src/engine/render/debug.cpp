@@ -0,0 +1,185 @@
+#include <cstring>
+#include <engine/core/renderer.hpp>
+#include <engine/render/debug.hpp>
+#include <engine/render/renderable.hpp>
+
+namespace Engine {
+#if ENGINE_ENABLE_DEBUG_DRAW
+namespace {
+constexpr size_t COMMAND_ALIGN = alignof(std::max_align_t);
+
+size_t AlignUp(size_t size) {
+    return (size + COMMAND_ALIGN - 1) & ~(COMMAND_ALIGN - 1);
+}
+} // namespace
+
+DebugDraw::DebugDraw(size_t arenaSize) : m_arena(arenaSize) {}
+
+size_t DebugDraw::CommandSize(const Command &command) {
+    size_t text =
+        command.type == CommandType::Text ? command.textLength + 1 : 0;
+    return AlignUp(sizeof(Command) + text);
+}
+
+DebugDraw::Command *DebugDraw::Push(CommandType type, Color color,
+                                    size_t extra) {
+    size_t size = AlignUp(sizeof(Command) + extra);
+    if (m_used + size > m_arena.size()) {
+        m_dropped++;
+        return nullptr;
+    }
+    Command *command = reinterpret_cast<Command *>(m_arena.data() + m_used);
+    m_used += size;
+    command->type = type;
+    command->textLength = 0;
+    command->color = color;
+    return command;
+}
+
+void DebugDraw::Line(Vector2 start, Vector2 end, Color color) {
+    if (Command *command = Push(CommandType::Line, color)) {
+        command->a = start.x;
+        command->b = start.y;
+        command->c = end.x;
+        command->d = end.y;
+    }
+}
+
+void DebugDraw::Rect(const ::Engine::Rect &rect, Color color, bool filled) {
+    CommandType type = filled ? CommandType::FillRect : CommandType::Rect;
+    if (Command *command = Push(type, color)) {
+        command->a = rect.x;
+        command->b = rect.y;
+        command->c = rect.w;
+        command->d = rect.h;
+    }
+}
+
+void DebugDraw::Circle(Vector2 center, float radius, Color color) {
+    if (Command *command = Push(CommandType::Circle, color)) {
+        command->a = center.x;
+        command->b = center.y;
+        command->c = radius;
+    }
+}
+
+void DebugDraw::Text(Vector2 pos, std::string_view text, Color color) {
+    if (Command *command = Push(CommandType::Text, color, text.size() + 1)) {
+        command->a = pos.x;
+        command->b = pos.y;
+        command->textLength = static_cast<uint32_t>(text.size());
+        char *dest = reinterpret_cast<char *>(command + 1);
+        std::memcpy(dest, text.data(), text.size());
+        dest[text.size()] = '\0';
+    }
+}
+
+void DebugDraw::Clear() {
+    m_used = 0;
+    m_dropped = 0;
+}
+
+// Lines become one pixel wide quads so every shape goes out in a single
+// geometry call, text is drawn afterwards on top.
+void DebugDraw::PushQuad(const SDL_FPoint (&corners)[4], SDL_FColor color) {
+    int base = static_cast<int>(m_vertices.size());
+    for (const SDL_FPoint &corner : corners) {
+        m_vertices.push_back({corner, color, {0.0f, 0.0f}});
+    }
+    for (int index : {0, 1, 2, 0, 2, 3}) {
+        m_indices.push_back(base + index);
+    }
+}
+
+void DebugDraw::PushSegment(Vector2 start, Vector2 end, SDL_FColor color) {
+    Vector2 dir = end - start;
+    float length = SDL_sqrtf(dir.x * dir.x + dir.y * dir.y);
+    if (length == 0.0f) {
+        return;
+    }
+    float nx = -dir.y / length * 0.5f;
+    float ny = dir.x / length * 0.5f;
+    SDL_FPoint corners[4] = {{start.x + nx, start.y + ny},
+                             {end.x + nx, end.y + ny},
+                             {end.x - nx, end.y - ny},
+                             {start.x - nx, start.y - ny}};
+    PushQuad(corners, color);
+}
+
+void DebugDraw::Flush(Renderer &renderer) {
+    m_vertices.clear();
+    m_indices.clear();
+
+    size_t offset = 0;
+    while (offset < m_used) {
+        const Command *command =
+            reinterpret_cast<const Command *>(m_arena.data() + offset);
+        offset += CommandSize(*command);
+        SDL_FColor color = command->color.ToSDLFColor();
+        switch (command->type) {
+        case CommandType::Line:
+            PushSegment(Vector2(command->a, command->b),
+                        Vector2(command->c, command->d), color);
+            break;
+        case CommandType::Rect: {
+            Vector2 min(command->a, command->b);
+            Vector2 max(command->a + command->c, command->b + command->d);
+            PushSegment(min, Vector2(max.x, min.y), color);
+            PushSegment(Vector2(max.x, min.y), max, color);
+            PushSegment(max, Vector2(min.x, max.y), color);
+            PushSegment(Vector2(min.x, max.y), min, color);
+            break;
+        }
+        case CommandType::FillRect: {
+            float x = command->a;
+            float y = command->b;
+            SDL_FPoint corners[4] = {{x, y},
+                                     {x + command->c, y},
+                                     {x + command->c, y + command->d},
+                                     {x, y + command->d}};
+            PushQuad(corners, color);
+            break;
+        }
+        case CommandType::Circle: {
+            float radius = command->c;
+            int segments = CircleShape::SegmentsForRadius(radius);
+            Vector2 center(command->a, command->b);
+            Vector2 prev(center.x + radius, center.y);
+            for (int i = 1; i <= segments; i++) {
+                float angle = 2.0f * SDL_PI_F * i / segments;
+                Vector2 next(center.x + radius * SDL_cosf(angle),
+                             center.y + radius * SDL_sinf(angle));
+                PushSegment(prev, next, color);
+                prev = next;
+            }
+            break;
+        }
+        case CommandType::Text:
+            break;
+        }
+    }
+
+    if (!m_indices.empty()) {
+        renderer.DrawGeometry(nullptr, m_vertices.data(), m_vertices.size(),
+                              m_indices.data(), m_indices.size());
+    }
+
+    offset = 0;
+    while (offset < m_used) {
+        const Command *command =
+            reinterpret_cast<const Command *>(m_arena.data() + offset);
+        offset += CommandSize(*command);
+        if (command->type != CommandType::Text) {
+            continue;
+        }
+        renderer.SetDrawColor(command->color);
+        renderer.DrawDebugText(Vector2(command->a, command->b),
+                               reinterpret_cast<const char *>(command + 1));
+    }
+
+    Clear();
+}
+#else
+DebugDraw::DebugDraw(size_t) {}
+#endif
+} // namespace Engine
@@ -1,8 +1,24 @@
+#include <cstring>
+#include <engine/core/commands.hpp>
 #include <engine/core/renderer.hpp>
 #include <engine/render/layer.hpp>
 #include <engine/render/renderable.hpp>
+#include <engine/util/transform.hpp>
 
 namespace Engine {
+namespace {
+// Past this many shifts per renderable the order changed too much for
+// insertion sort to pay off and a full sort takes over.
+constexpr size_t MAX_SORT_SHIFTS = 8;
+
+// Maps floats to unsigned ints that compare in the same order
+uint32_t OrderedBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) != 0 ? ~bits : bits | 0x80000000u;
+}
+} // namespace
+
 Layer::Layer(int layerId, std::string_view name) {
     m_layerId = layerId;
     m_name = name;
@@ -10,7 +26,7 @@ Layer::Layer(int layerId, std::string_view name) {
 
 Layer::~Layer() { Clear(); }
 
-void Layer::Add(std::unique_ptr<Renderable> renderable) {
+void Layer::Add(RenderablePtr renderable) {
     if (!renderable) {
         return;
     }
@@ -41,7 +57,9 @@ bool Layer::Remove(std::string_view name) {
             std::find_if(m_renderables.begin(), m_renderables.end(),
                          [target](const auto &r) { return r.get() == target; });
         if (rIt != m_renderables.end()) {
+            AddRemovedDamage(**rIt);
             m_renderables.erase(rIt);
+            m_bounds.clear();
             return true;
         }
     }
@@ -60,7 +78,9 @@ bool Layer::Remove(Renderable *renderable) {
         m_renderables.begin(), m_renderables.end(),
         [renderable](const auto &r) { return r.get() == renderable; });
     if (it != m_renderables.end()) {
+        AddRemovedDamage(**it);
         m_renderables.erase(it);
+        m_bounds.clear();
         return true;
     }
     return false;
@@ -69,6 +89,8 @@ bool Layer::Remove(Renderable *renderable) {
 void Layer::Clear() {
     m_renderables.clear();
     m_nameMap.clear();
+    m_bounds.clear();
+    m_dirty = true;
 }
 
 Layer &Layer::Position(Vector2 pos) {
@@ -97,52 +119,229 @@ std::vector<Renderable *> Layer::GetRenderables() const {
     return result;
 }
 
-void Layer::Render(Renderer &renderer) {
-    if (!m_visible || m_renderables.empty())
+// Layer opacity is applied by fading the renderable's color for the draw,
+// without leaving it marked as changed for damage tracking.
+void Layer::RenderItem(Renderer &renderer, Renderable &renderable) {
+    if (m_opacity >= 1.0f) {
+        renderable.Render(renderer);
+        return;
+    }
+    bool wasDirty = renderable.IsDirty();
+    Color origColor = renderable.GetColor();
+    Color adjustedColor = origColor;
+    adjustedColor.a = static_cast<uint8_t>(origColor.a * m_opacity);
+
+    renderable.SetColor(adjustedColor);
+    renderable.Render(renderer);
+    renderable.SetColor(origColor);
+    if (!wasDirty) {
+        renderable.ClearDirty();
+    }
+}
+
+void Layer::AddRemovedDamage(const Renderable &renderable) {
+    Rect bounds;
+    if (!renderable.GetDamageBounds(bounds)) {
+        return;
+    }
+    m_removedDamage =
+        m_hasRemovedDamage ? m_removedDamage.Union(bounds) : bounds;
+    m_hasRemovedDamage = true;
+}
+
+bool Layer::TakeRemovedDamage(Rect &damage) {
+    bool hasDamage = m_hasRemovedDamage;
+    damage = m_removedDamage;
+    m_hasRemovedDamage = false;
+    return hasDamage;
+}
+
+uint64_t Layer::GetSortKey(const Renderable &renderable) const {
+    uint64_t major = 0;
+    switch (m_sortMode) {
+    case SortMode::Y:
+        major = OrderedBits(renderable.GetPosition().y);
+        break;
+    case SortMode::TextureThenZ: {
+        // only the grouping matters, so the address folded into 32 bits
+        // does, a rare collision merely interleaves two groups
+        uintptr_t texture =
+            reinterpret_cast<uintptr_t>(renderable.GetDrawTexture());
+        major = static_cast<uint32_t>(texture >> 4);
+        break;
+    }
+    default:
+        break;
+    }
+    return major << 32 | OrderedBits(renderable.GetZ());
+}
+
+void Layer::Sort() {
+    size_t count = m_renderables.size();
+    if (m_sortMode == SortMode::None || count < 2) {
         return;
+    }
+    m_sortKeys.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_sortKeys[i] = GetSortKey(*m_renderables[i]);
+    }
+
+    // Insertion sort, stable and linear on an already sorted layer. If it
+    // bails out the prefix is sorted and the rest untouched, which the
+    // stable full sort finishes without changing the order of equal keys.
+    size_t shiftBudget = count * MAX_SORT_SHIFTS;
+    size_t shifts = 0;
+    bool moved = false;
+    for (size_t i = 1; i < count; i++) {
+        uint64_t key = m_sortKeys[i];
+        if (m_sortKeys[i - 1] <= key) {
+            continue;
+        }
+        RenderablePtr renderable = std::move(m_renderables[i]);
+        size_t j = i;
+        while (j > 0 && m_sortKeys[j - 1] > key) {
+            m_sortKeys[j] = m_sortKeys[j - 1];
+            m_renderables[j] = std::move(m_renderables[j - 1]);
+            j--;
+        }
+        m_sortKeys[j] = key;
+        m_renderables[j] = std::move(renderable);
+        moved = true;
+        shifts += i - j;
+        if (shifts > shiftBudget) {
+            SortFully();
+            break;
+        }
+    }
+    if (moved) {
+        // cached bounds are parallel to the old order
+        m_bounds.clear();
+    }
+}
+
+void Layer::SortFully() {
+    size_t count = m_renderables.size();
+    m_sortOrder.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        m_sortOrder[i] = static_cast<uint32_t>(i);
+    }
+    std::stable_sort(m_sortOrder.begin(), m_sortOrder.end(),
+                     [this](uint32_t a, uint32_t b) {
+                         return m_sortKeys[a] < m_sortKeys[b];
+                     });
+    m_sortScratch.clear();
+    m_sortScratch.reserve(count);
+    for (uint32_t index : m_sortOrder) {
+        m_sortScratch.push_back(std::move(m_renderables[index]));
+    }
+    m_renderables.swap(m_sortScratch);
+    m_sortScratch.clear();
+}
+
+// Only a layer that groups by texture lets the command list reorder its
+// draws, the others rely on the order they draw in.
+void Layer::BeginCommands(Renderer &renderer) const {
+    if (RenderCommandList *commands = renderer.GetRecording()) {
+        commands->BeginLayer(m_sortMode == SortMode::TextureThenZ);
+    }
+}
+
+void Layer::UpdateBounds() {
+    Sort();
+    m_bounds.resize(m_renderables.size());
+    m_hasBounds.resize(m_renderables.size());
+    for (size_t i = 0; i < m_renderables.size(); i++) {
+        Rect bounds;
+        m_hasBounds[i] = m_renderables[i]->GetLocalBounds(bounds);
+        if (m_hasBounds[i]) {
+            m_bounds[i] = m_renderables[i]->GetLocalTransform().ApplyBounds(
+                bounds);
+        }
+    }
+}
+
+void Layer::Cull(const Rect &rect, std::vector<Renderable *> &out) const {
+    for (size_t i = 0; i < m_renderables.size(); i++) {
+        Renderable *renderable = m_renderables[i].get();
+        if (!renderable->IsVisible()) {
+            continue;
+        }
+        // added since the last UpdateBounds or without bounds: keep
+        if (i >= m_bounds.size() || !m_hasBounds[i] ||
+            rect.Intersects(m_bounds[i])) {
+            out.push_back(renderable);
+        }
+    }
+}
+
+std::pmr::vector<Renderable *>
+Layer::GetRenderables(std::pmr::memory_resource *memory) const {
+    std::pmr::vector<Renderable *> result(memory);
+    result.reserve(m_renderables.size());
+    for (const auto &renderable : m_renderables) {
+        result.push_back(renderable.get());
+    }
+    return result;
+}
+
+void Layer::Render(Renderer &renderer,
+                   const std::vector<Renderable *> &visible) {
+    if (!m_visible || visible.empty())
+        return;
+    BeginCommands(renderer);
 
     Color prevColor = renderer.GetDrawColor();
     float prevOpacity = renderer.GetOpacity();
     renderer.PushBlendMode(m_blendMode);
-
     renderer.SetOpacity(m_opacity * prevOpacity);
+    renderer.PushTransform(GetLayerTransform());
 
-    for (auto &renderable : m_renderables) {
-        if (!renderable->IsVisible())
-            continue;
+    for (Renderable *renderable : visible) {
+        RenderItem(renderer, *renderable);
+    }
 
-        Color origColor = renderable->GetColor();
-        Color adjustedColor = origColor;
-        adjustedColor.a = static_cast<uint8_t>(origColor.a * m_opacity);
+    renderer.PopTransform();
+    renderer.PopBlendMode();
+    renderer.SetOpacity(prevOpacity);
+    renderer.SetDrawColor(prevColor);
+}
 
-        Vector2 origPos = renderable->GetPosition();
-        float origRot = renderable->GetRotation();
-        Vector2 origScale = renderable->GetScale();
+void Layer::Render(Renderer &renderer, const Rect *visibleRect) {
+    if (!m_visible || m_renderables.empty())
+        return;
+    Sort();
+    BeginCommands(renderer);
 
-        float rad = m_rotation * (M_PI / 180.0f);
-        float cosR = SDL_cosf(rad);
-        float sinR = SDL_sinf(rad);
-        Vector2 rotatedPos(origPos.x * cosR - origPos.y * sinR,
-                           origPos.x * sinR + origPos.y * cosR);
+    Color prevColor = renderer.GetDrawColor();
+    float prevOpacity = renderer.GetOpacity();
+    renderer.PushBlendMode(m_blendMode);
 
-        rotatedPos.x *= m_scale.x;
-        rotatedPos.y *= m_scale.y;
-        Vector2 finalPos = rotatedPos + m_position;
+    renderer.SetOpacity(m_opacity * prevOpacity);
+
+    renderer.PushTransform(GetLayerTransform());
 
-        renderable->SetPosition(finalPos);
-        renderable->SetRotation(origRot + m_rotation);
-        renderable->SetScale(
-            Vector2(origScale.x * m_scale.x, origScale.y * m_scale.y));
-        renderable->SetColor(adjustedColor);
+    // cull in layer space so each renderable only maps its own bounds
+    Rect layerVisible;
+    if (visibleRect != nullptr) {
+        layerVisible =
+            renderer.GetTransform().Inverse().ApplyBounds(*visibleRect);
+    }
 
-        renderable->Render(renderer);
+    for (auto &renderable : m_renderables) {
+        if (!renderable->IsVisible())
+            continue;
+
+        Rect bounds;
+        if (visibleRect != nullptr && renderable->GetLocalBounds(bounds) &&
+            !layerVisible.Intersects(
+                renderable->GetLocalTransform().ApplyBounds(bounds))) {
+            continue;
+        }
 
-        renderable->SetPosition(origPos);
-        renderable->SetRotation(origRot);
-        renderable->SetScale(origScale);
-        renderable->SetColor(origColor);
+        RenderItem(renderer, *renderable);
     }
 
+    renderer.PopTransform();
     renderer.PopBlendMode();
     renderer.SetOpacity(prevOpacity);
     renderer.SetDrawColor(prevColor);
@@ -17,32 +17,12 @@ void Line::Render(Renderer &renderer) {
 
     renderer.SetDrawColor(m_color);
 
-    float rad = m_rotation * (M_PI / 180.0f);
-    float cosTheta = SDL_cosf(rad);
-    float sinTheta = SDL_sinf(rad);
-
-    float scaledEndX = m_relativeEndPoint.x * m_scale.x;
-    float scaledEndY = m_relativeEndPoint.y * m_scale.y;
-
-    float rotatedEndX = scaledEndX * cosTheta - scaledEndY * sinTheta;
-    float rotatedEndY = scaledEndX * sinTheta + scaledEndY * cosTheta;
-
-    Vector2 absoluteEndPoint =
-        Vector2(m_position.x + rotatedEndX, m_position.y + rotatedEndY);
-
-    renderer.DrawLine(m_position, absoluteEndPoint);
+    Transform2D transform = renderer.GetTransform() * GetLocalTransform();
+    renderer.DrawLine(transform.GetTranslation(),
+                      transform.Apply(m_relativeEndPoint));
 }
 
 Vector2 Line::GetAbsoluteEndPoint() {
-    float rad = m_rotation * (M_PI / 180.0f);
-    float cosTheta = SDL_cosf(rad);
-    float sinTheta = SDL_sinf(rad);
-
-    float scaledEndX = m_relativeEndPoint.x * m_scale.x;
-    float scaledEndY = m_relativeEndPoint.y * m_scale.y;
-
-    return Vector2(m_position.x + scaledEndX * cosTheta - scaledEndY * sinTheta,
-                   m_position.y + scaledEndX * sinTheta +
-                       scaledEndY * cosTheta);
+    return GetLocalTransform().Apply(m_relativeEndPoint);
 }
 } // namespace Engine
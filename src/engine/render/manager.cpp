@@ -1,43 +1,123 @@
+#include <algorithm>
 #include <engine/render/manager.hpp>
 #include <engine/render/renderable.hpp>
+#include <engine/util/memory.hpp>
+#include <iterator>
 
 namespace Engine {
+namespace {
+constexpr int32_t NO_LAYER = -1;
+// ids below this go in the flat index, which covers the built in layers and
+// the first few thousand custom ones in well under a megabyte
+constexpr int MAX_DENSE_LAYER_ID = Layers::USER_DEFINED_START * 2;
 
-std::unordered_map<int, std::string> RenderManager::s_layerNames = {
+const std::pair<int, const char *> DEFAULT_LAYER_NAMES[] = {
     {Layers::BACKGROUND, "Background"},
     {Layers::WORLD, "World"},
     {Layers::ENTITIES, "Entities"},
     {Layers::FOREGROUND, "Foreground"},
     {Layers::UI, "UI"},
     {Layers::DEBUG, "Debug"}};
+} // namespace
 
-int RenderManager::s_nextCustomLayerId = Layers::USER_DEFINED_START;
+RenderManager::RenderManager()
+    : m_layerNames(std::begin(DEFAULT_LAYER_NAMES),
+                   std::end(DEFAULT_LAYER_NAMES)) {}
 
 RenderManager::~RenderManager() { Clear(); }
 
-Layer &RenderManager::GetLayer(int layerId) {
-    auto it = m_layers.find(layerId);
-    if (it == m_layers.end()) {
-        std::string layerName;
-        auto nameIt = s_layerNames.find(layerId);
-        if (nameIt != s_layerNames.end()) {
-            layerName = nameIt->second;
+int RenderManager::FindLayerIndex(int layerId) const {
+    if (layerId >= 0 && layerId < MAX_DENSE_LAYER_ID) {
+        size_t slot = static_cast<size_t>(layerId);
+        return slot < m_layerIndex.size() ? m_layerIndex[slot] : NO_LAYER;
+    }
+    auto it = m_sparseLayerIndex.find(layerId);
+    return it != m_sparseLayerIndex.end() ? it->second : NO_LAYER;
+}
+
+void RenderManager::SetLayerIndex(int layerId, int32_t index) {
+    if (layerId >= 0 && layerId < MAX_DENSE_LAYER_ID) {
+        size_t slot = static_cast<size_t>(layerId);
+        if (slot >= m_layerIndex.size()) {
+            m_layerIndex.resize(slot + 1, NO_LAYER);
         }
+        m_layerIndex[slot] = index;
+    } else {
+        m_sparseLayerIndex[layerId] = index;
+    }
+}
+
+Layer *RenderManager::FindLayer(int layerId) {
+    int index = FindLayerIndex(layerId);
+    return index != NO_LAYER ? &m_layers[index] : nullptr;
+}
+
+const Layer *RenderManager::FindLayer(int layerId) const {
+    int index = FindLayerIndex(layerId);
+    return index != NO_LAYER ? &m_layers[index] : nullptr;
+}
+
+// Inserts in key order and reindexes every layer that moved up
+Layer &RenderManager::InsertLayer(Layer layer, LayerKey key) {
+    auto keyIt = std::upper_bound(m_layerKeys.begin(), m_layerKeys.end(), key);
+    size_t index = static_cast<size_t>(keyIt - m_layerKeys.begin());
+    m_layerKeys.insert(keyIt, key);
+    m_layers.insert(m_layers.begin() + index, std::move(layer));
+    for (size_t i = index; i < m_layers.size(); i++) {
+        SetLayerIndex(m_layers[i].GetLayerId(), static_cast<int32_t>(i));
+    }
+    return m_layers[index];
+}
 
-        auto [newIt, inserted] = m_layers.emplace(
-            std::piecewise_construct, std::forward_as_tuple(layerId),
-            std::forward_as_tuple(layerId, layerName));
-        return newIt->second;
+Layer &RenderManager::GetLayer(int layerId) {
+    Layer *existing = FindLayer(layerId);
+    if (existing != nullptr) {
+        return *existing;
+    }
+    MemoryScope memoryScope(MemoryTag::RenderManager);
+    std::string layerName;
+    auto nameIt = m_layerNames.find(layerId);
+    if (nameIt != m_layerNames.end()) {
+        layerName = nameIt->second;
     }
-    return it->second;
+    Layer layer(layerId, layerName);
+    if (layerId == Layers::UI || layerId == Layers::DEBUG) {
+        layer.SetScreenSpace(true);
+    }
+    return InsertLayer(std::move(layer),
+                       LayerKey{layerId, m_nextLayerSequence++});
 }
 
 bool RenderManager::HasLayer(int layerId) const {
-    return m_layers.find(layerId) != m_layers.end();
+    return FindLayerIndex(layerId) != NO_LAYER;
+}
+
+void RenderManager::SetLayerOrder(int layerId, int order) {
+    GetLayer(layerId);
+    size_t index = static_cast<size_t>(FindLayerIndex(layerId));
+    LayerKey key = m_layerKeys[index];
+    if (key.order == order) {
+        return;
+    }
+    MemoryScope memoryScope(MemoryTag::RenderManager);
+    // the creation sequence stays, so ties keep resolving the same way
+    key.order = order;
+    Layer layer = std::move(m_layers[index]);
+    m_layers.erase(m_layers.begin() + index);
+    m_layerKeys.erase(m_layerKeys.begin() + index);
+    for (size_t i = index; i < m_layers.size(); i++) {
+        SetLayerIndex(m_layers[i].GetLayerId(), static_cast<int32_t>(i));
+    }
+    InsertLayer(std::move(layer), key).MarkDirty();
 }
 
-void RenderManager::AddRenderable(std::unique_ptr<Renderable> renderable,
-                                  int layerId) {
+int RenderManager::GetLayerOrder(int layerId) const {
+    int index = FindLayerIndex(layerId);
+    return index != NO_LAYER ? m_layerKeys[index].order : layerId;
+}
+
+void RenderManager::AddRenderable(RenderablePtr renderable, int layerId) {
+    MemoryScope memoryScope(MemoryTag::RenderManager);
     if (!renderable) {
         return;
     }
@@ -48,7 +128,7 @@ bool RenderManager::RemoveRenderable(std::string_view name) {
     if (name.empty()) {
         return false;
     }
-    for (auto &[id, layer] : m_layers) {
+    for (Layer &layer : m_layers) {
         if (layer.Remove(name)) {
             return true;
         }
@@ -60,7 +140,7 @@ Renderable *RenderManager::GetRenderable(std::string_view name) {
     if (name.empty()) {
         return nullptr;
     }
-    for (auto &[id, layer] : m_layers) {
+    for (Layer &layer : m_layers) {
         Renderable *renderable = layer.Find(name);
         if (renderable) {
             return renderable;
@@ -71,33 +151,41 @@ Renderable *RenderManager::GetRenderable(std::string_view name) {
 
 Renderable *RenderManager::GetRenderableInLayer(std::string_view name,
                                                 int layerId) {
-    auto it = m_layers.find(layerId);
-    if (it != m_layers.end()) {
-        return it->second.Find(name);
-    }
-    return nullptr;
+    Layer *layer = FindLayer(layerId);
+    return layer != nullptr ? layer->Find(name) : nullptr;
 }
 
 std::vector<Renderable *> RenderManager::GetRenderablesInLayer(int layerId) {
-    std::vector<Renderable *> result;
-
-    auto it = m_layers.find(layerId);
-    if (it != m_layers.end()) {
-        const auto &layerRenderables = it->second.GetRenderables();
-        result.reserve(layerRenderables.size());
-
-        for (Renderable *renderable : layerRenderables) {
-            result.push_back(renderable);
-        }
+    MemoryScope memoryScope(MemoryTag::RenderManager);
+    Layer *layer = FindLayer(layerId);
+    if (layer != nullptr) {
+        return layer->GetRenderables();
     }
+    return {};
+}
 
-    return result;
+std::pmr::vector<Renderable *>
+RenderManager::GetRenderablesInLayer(int layerId,
+                                     std::pmr::memory_resource *memory) {
+    Layer *layer = FindLayer(layerId);
+    if (layer != nullptr) {
+        return layer->GetRenderables(memory);
+    }
+    return std::pmr::vector<Renderable *>(memory);
 }
 
 int RenderManager::CreateCustomLayer(int layerInFront) {
-    int newLayerId = s_nextCustomLayerId++;
+    // ids picked by hand or named ahead of time may sit in the custom range
+    while (HasLayer(m_nextCustomLayerId) ||
+           m_layerNames.count(m_nextCustomLayerId) != 0) {
+        m_nextCustomLayerId++;
+    }
+    int newLayerId = m_nextCustomLayerId++;
+    GetLayer(newLayerId);
     if (layerInFront != -1) {
-        newLayerId = layerInFront - 1;
+        // one below, and created last among its equals, puts it directly
+        // behind layerInFront
+        SetLayerOrder(newLayerId, GetLayerOrder(layerInFront) - 1);
     }
     return newLayerId;
 }
@@ -110,22 +198,24 @@ int RenderManager::CreateCustomLayer(std::string_view layerName,
 }
 
 void RenderManager::RegisterLayerName(int layerId, std::string_view layerName) {
-    s_layerNames[layerId] = std::string(layerName);
+    MemoryScope memoryScope(MemoryTag::RenderManager);
+    m_layerNames[layerId] = std::string(layerName);
 
-    auto it = m_layers.find(layerId);
-    if (it != m_layers.end()) {
-        it->second.SetLayerName(std::string(layerName));
+    Layer *layer = FindLayer(layerId);
+    if (layer != nullptr) {
+        layer->SetLayerName(layerName);
     }
 }
 
 std::string_view RenderManager::GetLayerName(int layerId) {
     static const std::string empty_string = "";
-    auto it = s_layerNames.find(layerId);
-    return (it != s_layerNames.end()) ? it->second : empty_string;
+    auto it = m_layerNames.find(layerId);
+    return (it != m_layerNames.end()) ? it->second : empty_string;
 }
 
 void RenderManager::CreateLayerGroup(std::string_view groupName,
                                      const std::vector<int> &layerIds) {
+    MemoryScope memoryScope(MemoryTag::RenderManager);
     m_layerGroups[std::string(groupName)] = layerIds;
 }
 
@@ -135,9 +225,9 @@ void RenderManager::SetGroupVisible(std::string_view groupName, bool visible) {
         return;
 
     for (int layerId : it->second) {
-        auto layerIt = m_layers.find(layerId);
-        if (layerIt != m_layers.end()) {
-            layerIt->second.SetVisible(visible);
+        Layer *layer = FindLayer(layerId);
+        if (layer != nullptr) {
+            layer->SetVisible(visible);
         }
     }
 }
@@ -148,30 +238,292 @@ void RenderManager::SetGroupOpacity(std::string_view groupName, float opacity) {
         return;
 
     for (int layerId : it->second) {
-        auto layerIt = m_layers.find(layerId);
-        if (layerIt != m_layers.end()) {
-            layerIt->second.SetOpacity(opacity);
+        Layer *layer = FindLayer(layerId);
+        if (layer != nullptr) {
+            layer->SetOpacity(opacity);
         }
     }
 }
 
+int RenderManager::AddView(const RenderView &view) {
+    MemoryScope memoryScope(MemoryTag::RenderManager);
+    m_views.push_back(view);
+    m_viewCullLists.emplace_back();
+    return static_cast<int>(m_views.size() - 1);
+}
+
+void RenderManager::RemoveView(int index) {
+    if (index < 0 || index >= static_cast<int>(m_views.size())) {
+        return;
+    }
+    m_views.erase(m_views.begin() + index);
+    m_viewCullLists.erase(m_viewCullLists.begin() + index);
+}
+
+void RenderManager::ClearViews() {
+    m_views.clear();
+    m_viewCullLists.clear();
+}
+
+// Returns whether SubmitCommands should follow, which it should not when a
+// caller is recording the renderer already.
+bool RenderManager::BeginCommands(Renderer &renderer) {
+    if (renderer.GetRecording() != nullptr) {
+        return false;
+    }
+    m_commands.Clear();
+    renderer.BeginRecording(&m_commands);
+    return true;
+}
+
+void RenderManager::SubmitCommands(Renderer &renderer) {
+    renderer.EndRecording();
+    m_commands.Sort();
+    renderer.Submit(m_commands);
+}
+
 void RenderManager::RenderAll(Renderer &renderer) {
-    for (auto &[id, layer] : m_layers) {
+    MemoryScope memoryScope(MemoryTag::RenderManager);
+    if (!m_views.empty()) {
+        // each view submits its own list in its viewport, which an outer
+        // recording would lose
+        if (renderer.GetRecording() != nullptr) {
+            SDL_SetError("RenderAll with views while recording");
+            return;
+        }
+        RenderViews(renderer);
+        return;
+    }
+    bool submit = BeginCommands(renderer);
+    for (Layer &layer : m_layers) {
         if (layer.IsVisible()) {
-            layer.Render(renderer);
+            RenderLayerWithCamera(layer, renderer);
         }
     }
+    if (submit) {
+        SubmitCommands(renderer);
+    }
 }
 
 void RenderManager::RenderLayer(int layerId, Renderer &renderer) {
-    auto it = m_layers.find(layerId);
-    if (it != m_layers.end() && it->second.IsVisible()) {
-        it->second.Render(renderer);
+    MemoryScope memoryScope(MemoryTag::RenderManager);
+    Layer *layer = FindLayer(layerId);
+    if (layer != nullptr && layer->IsVisible()) {
+        bool submit = BeginCommands(renderer);
+        RenderLayerWithCamera(*layer, renderer);
+        if (submit) {
+            SubmitCommands(renderer);
+        }
+    }
+}
+
+Transform2D RenderManager::GetLayerViewTransform(const Layer &layer) const {
+    if (m_camera == nullptr || layer.IsScreenSpace()) {
+        return Transform2D();
+    }
+    return m_camera->GetViewTransform(layer.GetParallax());
+}
+
+void RenderManager::RenderLayerWithCamera(Layer &layer, Renderer &renderer,
+                                          const Rect *cullRect) {
+    if (m_camera == nullptr || layer.IsScreenSpace()) {
+        layer.Render(renderer, cullRect);
+        return;
+    }
+    // a little slack for outlines and lines that reach past their bounds
+    constexpr float CULL_MARGIN = 2.0f;
+    Vector2 size = m_camera->GetViewportSize();
+    Rect visible(-CULL_MARGIN, -CULL_MARGIN, size.x + CULL_MARGIN * 2.0f,
+                 size.y + CULL_MARGIN * 2.0f);
+    renderer.SetViewTransform(GetLayerViewTransform(layer));
+    layer.Render(renderer, cullRect != nullptr ? cullRect : &visible);
+    renderer.SetViewTransform(Transform2D());
+}
+
+// Returns whether anything needs redrawing. Every dirty renderable's screen
+// bounds are refreshed, or all of them when full is set.
+bool RenderManager::CollectDamage(Rect &damage, bool &full) {
+    constexpr float DAMAGE_MARGIN = 2.0f;
+    bool hasDamage = false;
+    auto addDamage = [&](const Rect &rect) {
+        damage = hasDamage ? damage.Union(rect) : rect;
+        hasDamage = true;
+    };
+
+    Transform2D cameraView =
+        m_camera != nullptr ? m_camera->GetViewTransform() : Transform2D();
+    if (m_camera != m_lastCamera || cameraView != m_lastCameraView) {
+        full = true;
+    }
+    m_lastCamera = m_camera;
+    m_lastCameraView = cameraView;
+
+    for (Layer &layer : m_layers) {
+        if (layer.TakeDirty()) {
+            full = true;
+        }
+        Rect removed;
+        if (layer.TakeRemovedDamage(removed)) {
+            addDamage(removed);
+        }
+    }
+
+    for (Layer &layer : m_layers) {
+        Transform2D toScreen =
+            GetLayerViewTransform(layer) * layer.GetLayerTransform();
+        bool layerVisible = layer.IsVisible();
+        layer.ForEachRenderable([&](Renderable &renderable) {
+            if (!full && !renderable.IsDirty()) {
+                return;
+            }
+            Rect previous;
+            bool hadPrevious = renderable.GetDamageBounds(previous);
+            bool visible = layerVisible && renderable.IsVisible();
+            Rect local;
+            bool hasBounds = visible && renderable.GetLocalBounds(local);
+            Rect current;
+            if (hasBounds) {
+                current = (toScreen * renderable.GetLocalTransform())
+                              .ApplyBounds(local);
+                current = Rect(current.x - DAMAGE_MARGIN,
+                               current.y - DAMAGE_MARGIN,
+                               current.w + DAMAGE_MARGIN * 2.0f,
+                               current.h + DAMAGE_MARGIN * 2.0f);
+            } else if (visible) {
+                full = true;
+            }
+            if (hadPrevious) {
+                addDamage(previous);
+            }
+            if (hasBounds) {
+                addDamage(current);
+            }
+            renderable.SetDamageBounds(current, hasBounds);
+            renderable.ClearDirty();
+        });
+    }
+    return full || hasDamage;
+}
+
+bool RenderManager::RenderDamaged(Renderer &renderer, Color clearColor,
+                                  bool force) {
+    MemoryScope memoryScope(MemoryTag::RenderManager);
+    // the target switches and the final copy are not recorded, so an outer
+    // list would draw the pass into the window after that copy
+    if (renderer.GetRecording() != nullptr) {
+        SDL_SetError("RenderDamaged while recording");
+        return false;
     }
+    bool recreated = false;
+    SDL_Texture *target = renderer.GetRetainedTarget(recreated);
+    if (target == nullptr) {
+        renderer.Clear(clearColor);
+        RenderAll(renderer);
+        return true;
+    }
+
+    // views draw into viewports of their own, not worth tracking
+    bool full = recreated || !m_views.empty();
+    Rect damage;
+    if (!CollectDamage(damage, full)) {
+        if (force) {
+            renderer.DrawTexture(target, nullptr, nullptr);
+        }
+        return force;
+    }
+
+    float width = static_cast<float>(target->w);
+    float height = static_cast<float>(target->h);
+    if (full) {
+        damage = Rect(0.0f, 0.0f, width, height);
+    } else {
+        // whole pixels inside the target
+        float left = SDL_max(SDL_floorf(damage.x), 0.0f);
+        float top = SDL_max(SDL_floorf(damage.y), 0.0f);
+        float right = SDL_min(SDL_ceilf(damage.x + damage.w), width);
+        float bottom = SDL_min(SDL_ceilf(damage.y + damage.h), height);
+        damage = Rect(left, top, SDL_max(right - left, 0.0f),
+                      SDL_max(bottom - top, 0.0f));
+    }
+
+    renderer.SetTarget(target);
+    renderer.SetClipRect(&damage);
+    renderer.PushBlendMode(BlendMode::None);
+    renderer.SetDrawColor(clearColor);
+    renderer.FillRect(damage);
+    renderer.PopBlendMode();
+
+    if (!m_views.empty()) {
+        RenderViews(renderer);
+    } else {
+        BeginCommands(renderer);
+        for (Layer &layer : m_layers) {
+            if (layer.IsVisible()) {
+                RenderLayerWithCamera(layer, renderer, &damage);
+            }
+        }
+        SubmitCommands(renderer);
+    }
+
+    renderer.SetClipRect(nullptr);
+    renderer.SetTarget(nullptr);
+    renderer.DrawTexture(target, nullptr, nullptr);
+    return true;
+}
+
+// Bounds are brought into layer space once per frame and shared, each view
+// then only maps its own viewport into every layer and tests those bounds.
+// Shape vertex caches hold a single transform, and circles a segment count
+// picked from their on screen radius, so with views that differ in camera
+// or zoom every drawn shape maps its points again, and a circle may also
+// refill its colors, in each view.
+void RenderManager::RenderViews(Renderer &renderer) {
+    constexpr float CULL_MARGIN = 2.0f;
+    for (Layer &layer : m_layers) {
+        if (layer.IsVisible()) {
+            layer.UpdateBounds();
+        }
+    }
+
+    for (size_t v = 0; v < m_views.size(); v++) {
+        const RenderView &view = m_views[v];
+        if (!view.enabled) {
+            continue;
+        }
+        std::vector<Renderable *> &visible = m_viewCullLists[v];
+        Rect screen(-CULL_MARGIN, -CULL_MARGIN,
+                    view.viewport.w + CULL_MARGIN * 2.0f,
+                    view.viewport.h + CULL_MARGIN * 2.0f);
+        renderer.SetViewport(view.viewport);
+
+        BeginCommands(renderer);
+        for (Layer &layer : m_layers) {
+            if (!layer.IsVisible() || !view.HasLayer(layer.GetLayerId())) {
+                continue;
+            }
+            Transform2D viewTransform;
+            if (view.camera != nullptr && !layer.IsScreenSpace()) {
+                viewTransform =
+                    view.camera->GetViewTransform(layer.GetParallax());
+            }
+            Transform2D toLayer =
+                (viewTransform * layer.GetLayerTransform()).Inverse();
+
+            visible.clear();
+            layer.Cull(toLayer.ApplyBounds(screen), visible);
+            renderer.SetViewTransform(viewTransform);
+            layer.Render(renderer, visible);
+        }
+        SubmitCommands(renderer);
+    }
+
+    renderer.SetViewTransform(Transform2D());
+    renderer.ResetViewport();
 }
 
 void RenderManager::RenderGroup(std::string_view groupName,
                                 Renderer &renderer) {
+    MemoryScope memoryScope(MemoryTag::RenderManager);
     auto it = m_layerGroups.find(std::string(groupName));
     if (it == m_layerGroups.end())
         return;
@@ -183,13 +535,16 @@ void RenderManager::RenderGroup(std::string_view groupName,
 
 void RenderManager::Clear() {
     m_layers.clear();
+    m_layerKeys.clear();
+    m_layerIndex.clear();
+    m_sparseLayerIndex.clear();
     m_layerGroups.clear();
 }
 
 void RenderManager::ClearLayer(int layerId) {
-    auto it = m_layers.find(layerId);
-    if (it != m_layers.end()) {
-        it->second.Clear();
+    Layer *layer = FindLayer(layerId);
+    if (layer != nullptr) {
+        layer->Clear();
     }
 }
 } // namespace Engine
@@ -0,0 +1,156 @@
+#include <engine/core/renderer.hpp>
+#include <engine/core/texture.hpp>
+#include <engine/render/particles.hpp>
+#include <utility>
+
+namespace Engine {
+ParticleEmitter::ParticleEmitter(size_t capacity,
+                                 std::shared_ptr<Texture> texture,
+                                 const EmitterProps &props)
+    : m_texture(std::move(texture)), m_props(props), m_capacity(capacity),
+      m_posX(capacity), m_posY(capacity), m_velX(capacity), m_velY(capacity),
+      m_age(capacity), m_lifetime(capacity), m_size(capacity),
+      m_colors(capacity), m_vertices(capacity * 4), m_indices(capacity * 6) {
+    for (size_t i = 0; i < capacity; i++) {
+        int base = static_cast<int>(i * 4);
+        int *quad = &m_indices[i * 6];
+        quad[0] = base;
+        quad[1] = base + 1;
+        quad[2] = base + 2;
+        quad[3] = base;
+        quad[4] = base + 2;
+        quad[5] = base + 3;
+    }
+}
+
+bool ParticleEmitter::Spawn(Vector2 pos, Vector2 velocity, float lifetime,
+                            Color color, float size) {
+    if (m_count == m_capacity || lifetime <= 0.0f) {
+        return false;
+    }
+    size_t i = m_count++;
+    m_posX[i] = pos.x;
+    m_posY[i] = pos.y;
+    m_velX[i] = velocity.x;
+    m_velY[i] = velocity.y;
+    m_age[i] = 0.0f;
+    m_lifetime[i] = lifetime;
+    m_size[i] = size;
+    m_colors[i] = color;
+    MarkDirty();
+    return true;
+}
+
+void ParticleEmitter::Kill(size_t index) {
+    if (index >= m_count) {
+        return;
+    }
+    size_t last = --m_count;
+    m_posX[index] = m_posX[last];
+    m_posY[index] = m_posY[last];
+    m_velX[index] = m_velX[last];
+    m_velY[index] = m_velY[last];
+    m_age[index] = m_age[last];
+    m_lifetime[index] = m_lifetime[last];
+    m_size[index] = m_size[last];
+    m_colors[index] = m_colors[last];
+    MarkDirty();
+}
+
+void ParticleEmitter::Emit(int count) {
+    for (int n = 0; n < count; n++) {
+        float angle = m_props.direction +
+                      m_props.spread * (SDL_randf_r(&m_randomState) * 2.0f -
+                                        1.0f);
+        float speed = m_props.speedMin + (m_props.speedMax - m_props.speedMin) *
+                                             SDL_randf_r(&m_randomState);
+        float lifetime =
+            m_props.lifetimeMin + (m_props.lifetimeMax - m_props.lifetimeMin) *
+                                      SDL_randf_r(&m_randomState);
+        float sinTheta, cosTheta;
+        SinCosDegrees(angle, sinTheta, cosTheta);
+        if (!Spawn(m_position, Vector2(cosTheta * speed, sinTheta * speed),
+                   lifetime, m_color, m_props.sizeStart)) {
+            break;
+        }
+    }
+}
+
+void ParticleEmitter::Update(float dt) {
+    size_t count = m_count;
+    if (count > 0) {
+        MarkDirty();
+    }
+    float gravityX = m_props.gravity.x * dt;
+    float gravityY = m_props.gravity.y * dt;
+    // plain loops over separate arrays so the compiler can vectorise them
+    float *velX = m_velX.data();
+    float *velY = m_velY.data();
+    float *posX = m_posX.data();
+    float *posY = m_posY.data();
+    float *age = m_age.data();
+    for (size_t i = 0; i < count; i++) {
+        velX[i] += gravityX;
+        velY[i] += gravityY;
+    }
+    for (size_t i = 0; i < count; i++) {
+        posX[i] += velX[i] * dt;
+        posY[i] += velY[i] * dt;
+        age[i] += dt;
+    }
+
+    // backwards so the particle swapped in by Kill was already checked
+    for (size_t i = m_count; i-- > 0;) {
+        if (m_age[i] >= m_lifetime[i]) {
+            Kill(i);
+        }
+    }
+
+    if (m_emitting && m_props.rate > 0.0f) {
+        m_emitAccumulator += m_props.rate * dt;
+        int spawn = static_cast<int>(m_emitAccumulator);
+        m_emitAccumulator -= static_cast<float>(spawn);
+        Emit(spawn);
+    }
+}
+
+void ParticleEmitter::Render(Renderer &renderer) {
+    if (!m_visible || m_count == 0) {
+        return;
+    }
+
+    // Particles are squares in layer space, so each corner is the transformed
+    // centre plus or minus the transformed half axes.
+    const Transform2D &transform = renderer.GetTransform();
+    Vector2 axisX = transform.ApplyVector(Vector2(0.5f, 0.0f));
+    Vector2 axisY = transform.ApplyVector(Vector2(0.0f, 0.5f));
+    float sizeRatio = m_props.sizeStart > 0.0f
+                          ? m_props.sizeEnd / m_props.sizeStart
+                          : 1.0f;
+
+    for (size_t i = 0; i < m_count; i++) {
+        float t = m_age[i] / m_lifetime[i];
+        float size = m_size[i] * (1.0f + (sizeRatio - 1.0f) * t);
+        float cx = transform.a * m_posX[i] + transform.c * m_posY[i] +
+                   transform.tx;
+        float cy = transform.b * m_posX[i] + transform.d * m_posY[i] +
+                   transform.ty;
+        float ax = axisX.x * size, ay = axisX.y * size;
+        float bx = axisY.x * size, by = axisY.y * size;
+
+        SDL_FColor color = m_colors[i].ToSDLFColor();
+        if (m_props.fadeOut) {
+            color.a *= 1.0f - t;
+        }
+        SDL_Vertex *quad = &m_vertices[i * 4];
+        quad[0] = {{cx - ax - bx, cy - ay - by}, color, {0.0f, 0.0f}};
+        quad[1] = {{cx + ax - bx, cy + ay - by}, color, {1.0f, 0.0f}};
+        quad[2] = {{cx + ax + bx, cy + ay + by}, color, {1.0f, 1.0f}};
+        quad[3] = {{cx - ax + bx, cy - ay + by}, color, {0.0f, 1.0f}};
+    }
+
+    SDL_Texture *texture = m_texture ? m_texture->GetSDLTexture() : nullptr;
+    renderer.DrawGeometry(texture, m_vertices.data(), m_count * 4,
+                          m_indices.data(), m_count * 6);
+}
+} // namespace Engine
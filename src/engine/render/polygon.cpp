@@ -0,0 +1,151 @@
+#include <engine/core/renderer.hpp>
+#include <engine/render/renderable.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace Engine {
+namespace {
+float Cross(Vector2 o, Vector2 a, Vector2 b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+bool InTriangle(Vector2 p, Vector2 a, Vector2 b, Vector2 c) {
+    return Cross(a, b, p) >= 0.0f && Cross(b, c, p) >= 0.0f &&
+           Cross(c, a, p) >= 0.0f;
+}
+
+// Ear clipping, O(n^2). Leaves indices empty if the polygon has no ears left
+// before it is fully clipped, which only happens for self-intersecting input.
+void Triangulate(const std::vector<Vector2> &points,
+                 std::vector<int> &indices) {
+    indices.clear();
+    int count = static_cast<int>(points.size());
+    if (count < 3) {
+        return;
+    }
+
+    float area = 0.0f;
+    for (int i = 0; i < count; i++) {
+        const Vector2 &p = points[i];
+        const Vector2 &q = points[(i + 1) % count];
+        area += p.x * q.y - q.x * p.y;
+    }
+    // walk the polygon so convex corners have a positive cross product
+    std::vector<int> remaining(count);
+    std::iota(remaining.begin(), remaining.end(), 0);
+    if (area < 0.0f) {
+        std::reverse(remaining.begin(), remaining.end());
+    }
+
+    indices.reserve((count - 2) * 3);
+    while (remaining.size() > 3) {
+        int size = static_cast<int>(remaining.size());
+        bool clipped = false;
+        for (int i = 0; i < size; i++) {
+            int prev = remaining[(i + size - 1) % size];
+            int cur = remaining[i];
+            int next = remaining[(i + 1) % size];
+            const Vector2 &a = points[prev];
+            const Vector2 &b = points[cur];
+            const Vector2 &c = points[next];
+            if (Cross(a, b, c) <= 0.0f) {
+                continue; // reflex or collinear
+            }
+            bool isEar = true;
+            for (int other : remaining) {
+                if (other != prev && other != cur && other != next &&
+                    InTriangle(points[other], a, b, c)) {
+                    isEar = false;
+                    break;
+                }
+            }
+            if (!isEar) {
+                continue;
+            }
+            indices.push_back(prev);
+            indices.push_back(cur);
+            indices.push_back(next);
+            remaining.erase(remaining.begin() + i);
+            clipped = true;
+            break;
+        }
+        if (!clipped) {
+            indices.clear();
+            return;
+        }
+    }
+    indices.push_back(remaining[0]);
+    indices.push_back(remaining[1]);
+    indices.push_back(remaining[2]);
+}
+} // namespace
+
+PolygonShape::PolygonShape(Vector2 pos, std::vector<Vector2> points,
+                           Color color, bool filled) {
+    m_filled = filled;
+    SetPosition(pos);
+    SetColor(color);
+    SetPivot(Vector2(0.0f, 0.0f));
+    SetPoints(std::move(points));
+}
+
+void PolygonShape::SetPoints(std::vector<Vector2> points) {
+    m_points = std::move(points);
+    m_bounds = Rect::FromPoints(m_points.data(), m_points.size());
+    Triangulate(m_points, m_indices);
+    m_geometryDirty = true;
+    MarkDirty();
+}
+
+void PolygonShape::Render(Renderer &renderer) {
+    if (!m_visible || m_points.size() < 2) {
+        return;
+    }
+
+    renderer.SetDrawColor(m_color);
+    if (m_geometryDirty || m_color != m_cachedColor) {
+        UpdateGeometry();
+    }
+    Transform2D transform = renderer.GetTransform() * GetLocalTransform();
+    if (!m_positionsValid || transform != m_cachedTransform) {
+        UpdatePositions(transform);
+    }
+
+    if (m_filled && !m_indices.empty()) {
+        renderer.DrawGeometry(nullptr, m_vertices.data(), m_vertices.size(),
+                              m_indices.data(), m_indices.size());
+    } else {
+        renderer.DrawLines(m_outline.data(), m_outline.size());
+    }
+}
+
+void PolygonShape::UpdateGeometry() {
+    size_t count = m_points.size();
+    SDL_FColor color = m_color.ToSDLFColor();
+    m_vertices.resize(count);
+    for (SDL_Vertex &vertex : m_vertices) {
+        vertex.color = color;
+        vertex.tex_coord = {0.0f, 0.0f};
+    }
+    m_outline.resize(count + 1);
+
+    m_cachedColor = m_color;
+    m_geometryDirty = false;
+    m_positionsValid = false;
+}
+
+void PolygonShape::UpdatePositions(const Transform2D &transform) {
+    size_t count = m_points.size();
+    m_transformed.resize(count);
+    TransformPoints(transform, m_points.data(), m_transformed.data(), count);
+    for (size_t i = 0; i < count; i++) {
+        SDL_FPoint point = m_transformed[i].ToSDLPoint();
+        m_vertices[i].position = point;
+        m_outline[i] = point;
+    }
+    m_outline[count] = m_outline[0];
+
+    m_cachedTransform = transform;
+    m_positionsValid = true;
+}
+} // namespace Engine
@@ -0,0 +1,103 @@
+#include <engine/core/renderer.hpp>
+#include <engine/render/renderable.hpp>
+
+namespace Engine {
+PolylineShape::PolylineShape(Vector2 pos, std::vector<Vector2> points,
+                             Color color, float thickness, bool closed) {
+    m_thickness = thickness;
+    m_closed = closed;
+    SetPosition(pos);
+    SetColor(color);
+    SetPivot(Vector2(0.0f, 0.0f));
+    SetPoints(std::move(points));
+}
+
+void PolylineShape::SetPoints(std::vector<Vector2> points) {
+    m_points = std::move(points);
+    m_bounds = Rect::FromPoints(m_points.data(), m_points.size());
+    m_geometryDirty = true;
+    MarkDirty();
+}
+
+void PolylineShape::SetThickness(float thickness) {
+    m_thickness = thickness;
+    m_geometryDirty = true;
+    MarkDirty();
+}
+
+void PolylineShape::SetClosed(bool closed) {
+    m_closed = closed;
+    m_geometryDirty = true;
+    MarkDirty();
+}
+
+void PolylineShape::Render(Renderer &renderer) {
+    if (!m_visible || m_points.size() < 2) {
+        return;
+    }
+
+    renderer.SetDrawColor(m_color);
+    Transform2D transform = renderer.GetTransform() * GetLocalTransform();
+    if (m_geometryDirty || transform != m_cachedTransform ||
+        m_color != m_cachedColor) {
+        UpdateGeometry(transform);
+    }
+
+    if (m_thickness > 1.0f) {
+        renderer.DrawGeometry(nullptr, m_vertices.data(), m_vertices.size(),
+                              m_indices.data(), m_indices.size());
+    } else {
+        renderer.DrawLines(m_linePoints.data(), m_linePoints.size());
+    }
+}
+
+void PolylineShape::UpdateGeometry(const Transform2D &transform) {
+    size_t count = m_points.size();
+    m_transformed.resize(count);
+    TransformPoints(transform, m_points.data(), m_transformed.data(), count);
+    if (m_closed) {
+        m_transformed.push_back(m_transformed.front());
+    }
+
+    m_linePoints.clear();
+    m_vertices.clear();
+    m_indices.clear();
+    if (m_thickness <= 1.0f) {
+        m_linePoints.reserve(m_transformed.size());
+        for (const Vector2 &point : m_transformed) {
+            m_linePoints.push_back(point.ToSDLPoint());
+        }
+    } else {
+        // one quad per segment, offset by half the width along its normal
+        SDL_FColor color = m_color.ToSDLFColor();
+        float halfWidth = m_thickness * 0.5f;
+        for (size_t i = 0; i + 1 < m_transformed.size(); i++) {
+            Vector2 start = m_transformed[i];
+            Vector2 end = m_transformed[i + 1];
+            Vector2 dir = end - start;
+            float length = SDL_sqrtf(dir.x * dir.x + dir.y * dir.y);
+            if (length == 0.0f) {
+                continue;
+            }
+            Vector2 normal(-dir.y / length * halfWidth,
+                           dir.x / length * halfWidth);
+            int base = static_cast<int>(m_vertices.size());
+            m_vertices.push_back(
+                {(start + normal).ToSDLPoint(), color, {0.0f, 0.0f}});
+            m_vertices.push_back(
+                {(end + normal).ToSDLPoint(), color, {0.0f, 0.0f}});
+            m_vertices.push_back(
+                {(end - normal).ToSDLPoint(), color, {0.0f, 0.0f}});
+            m_vertices.push_back(
+                {(start - normal).ToSDLPoint(), color, {0.0f, 0.0f}});
+            for (int index : {0, 1, 2, 0, 2, 3}) {
+                m_indices.push_back(base + index);
+            }
+        }
+    }
+
+    m_cachedTransform = transform;
+    m_cachedColor = m_color;
+    m_geometryDirty = false;
+}
+} // namespace Engine
@@ -18,89 +18,45 @@ void RectangleShape::Render(Renderer &renderer) {
     }
 
     renderer.SetDrawColor(m_color);
-    if (m_rotation == 0.0f) {
+    Transform2D transform = renderer.GetTransform() * GetLocalTransform();
+
+    float left = -m_pivot.x * m_width;
+    float top = -m_pivot.y * m_height;
+    Vector2 corners[4] = {Vector2(left, top), Vector2(left + m_width, top),
+                          Vector2(left + m_width, top + m_height),
+                          Vector2(left, top + m_height)};
+    TransformPoints(transform, corners, corners, 4);
+
+    if (transform.IsAxisAligned()) {
+        // corners 0 and 2 are opposite, a negative scale only swaps them
         Rect rect;
-        rect.w = m_width * m_scale.x;
-        rect.h = m_height * m_scale.y;
-        rect.x = m_position.x - (m_pivot.x * rect.w);
-        rect.y = m_position.y - (m_pivot.y * rect.h);
+        rect.x = SDL_min(corners[0].x, corners[2].x);
+        rect.y = SDL_min(corners[0].y, corners[2].y);
+        rect.w = SDL_fabsf(corners[2].x - corners[0].x);
+        rect.h = SDL_fabsf(corners[2].y - corners[0].y);
 
         if (m_filled) {
             renderer.FillRect(rect);
         } else {
             renderer.DrawRect(rect);
         }
-    } else {
-        float thetaRad = m_rotation * (M_PI / 180.0f);
-        float cosTheta = SDL_cosf(thetaRad);
-        float sinTheta = SDL_sinf(thetaRad);
-        float scaledWidth = m_width * m_scale.x;
-        float scaledHeight = m_height * m_scale.y;
-        float pivotOffsetX = m_pivot.x * scaledWidth;
-        float pivotOffsetY = m_pivot.y * scaledHeight;
-        SDL_FPoint offsets[4] = {
-            {-pivotOffsetX, -pivotOffsetY},
-            {scaledWidth - pivotOffsetX, -pivotOffsetY},
-            {scaledWidth - pivotOffsetX, scaledHeight - pivotOffsetY},
-            {-pivotOffsetX, scaledHeight - pivotOffsetY}};
-        if (m_filled) {
-            SDL_Vertex vertices[4];
-            int indices[6] = {0, 1, 2, 0, 2, 3};
-            for (int i = 0; i < 4; ++i) {
-                float rotatedOffsetX =
-                    offsets[i].x * cosTheta - offsets[i].y * sinTheta;
-                float rotatedOffsetY =
-                    offsets[i].x * sinTheta + offsets[i].y * cosTheta;
-
-                vertices[i].position = {m_position.x + rotatedOffsetX,
-                                        m_position.y + rotatedOffsetY};
-                vertices[i].color = {
-                    (float)m_color.r / 255.0f, (float)m_color.g / 255.0f,
-                    (float)m_color.b / 255.0f, (float)m_color.a / 255.0f};
-                vertices[i].tex_coord = {0.0f, 0.0f};
-            }
-
-            SDL_RenderGeometry(renderer.GetSDLRenderer(), nullptr, vertices, 4,
-                               indices, 6);
-        } else {
-            renderer.SetDrawColor(m_color);
-            renderer.DrawLine(
-                Vector2(m_position.x +
-                            (offsets[0].x * cosTheta - offsets[0].y * sinTheta),
-                        m_position.y + (offsets[0].x * sinTheta +
-                                        offsets[0].y * cosTheta)),
-                Vector2(m_position.x +
-                            (offsets[1].x * cosTheta - offsets[1].y * sinTheta),
-                        m_position.y + (offsets[1].x * sinTheta +
-                                        offsets[1].y * cosTheta)));
-            renderer.DrawLine(
-                Vector2(m_position.x +
-                            (offsets[1].x * cosTheta - offsets[1].y * sinTheta),
-                        m_position.y + (offsets[1].x * sinTheta +
-                                        offsets[1].y * cosTheta)),
-                Vector2(m_position.x +
-                            (offsets[2].x * cosTheta - offsets[2].y * sinTheta),
-                        m_position.y + (offsets[2].x * sinTheta +
-                                        offsets[2].y * cosTheta)));
-            renderer.DrawLine(
-                Vector2(m_position.x +
-                            (offsets[2].x * cosTheta - offsets[2].y * sinTheta),
-                        m_position.y + (offsets[2].x * sinTheta +
-                                        offsets[2].y * cosTheta)),
-                Vector2(m_position.x +
-                            (offsets[3].x * cosTheta - offsets[3].y * sinTheta),
-                        m_position.y + (offsets[3].x * sinTheta +
-                                        offsets[3].y * cosTheta)));
-            renderer.DrawLine(
-                Vector2(m_position.x +
-                            (offsets[0].x * cosTheta - offsets[0].y * sinTheta),
-                        m_position.y + (offsets[0].x * sinTheta +
-                                        offsets[0].y * cosTheta)),
-                Vector2(m_position.x +
-                            (offsets[3].x * cosTheta - offsets[3].y * sinTheta),
-                        m_position.y + (offsets[3].x * sinTheta +
-                                        offsets[3].y * cosTheta)));
+    } else if (m_filled) {
+        SDL_Vertex vertices[4];
+        int indices[6] = {0, 1, 2, 0, 2, 3};
+        SDL_FColor color = m_color.ToSDLFColor();
+        for (int i = 0; i < 4; ++i) {
+            vertices[i].position = corners[i].ToSDLPoint();
+            vertices[i].color = color;
+            vertices[i].tex_coord = {0.0f, 0.0f};
         }
+
+        renderer.DrawGeometry(nullptr, vertices, 4, indices, 6);
+    } else {
+        SDL_FPoint outline[5] = {
+            corners[0].ToSDLPoint(), corners[1].ToSDLPoint(),
+            corners[2].ToSDLPoint(), corners[3].ToSDLPoint(),
+            corners[0].ToSDLPoint()};
+        renderer.DrawLines(outline, 5);
     }
 }
 } // namespace Engine
@@ -1,5 +1,6 @@
 #include <engine/core/texture.hpp>
 #include <engine/render/renderable.hpp>
+#include <utility>
 
 namespace Engine {
 Sprite::Sprite(std::shared_ptr<Texture> texture, Vector2 pos) {
@@ -12,25 +13,41 @@ void Sprite::Render(Renderer &renderer) {
         return;
     }
 
-    SDL_FRect destRect;
-    destRect.w = m_sourceRect.w * m_scale.x;
-    destRect.h = m_sourceRect.h * m_scale.y;
-    destRect.x = m_position.x - (m_pivot.x * destRect.w);
-    destRect.y = m_position.y - (m_pivot.y * destRect.h);
+    // A textured quad instead of SDL_RenderTextureRotated so the layer's
+    // transform composes with the sprite's own, skew included.
+    Transform2D transform = renderer.GetTransform() * GetLocalTransform();
+    float left = -m_pivot.x * m_sourceRect.w;
+    float top = -m_pivot.y * m_sourceRect.h;
+    Vector2 corners[4] = {
+        Vector2(left, top), Vector2(left + m_sourceRect.w, top),
+        Vector2(left + m_sourceRect.w, top + m_sourceRect.h),
+        Vector2(left, top + m_sourceRect.h)};
+    TransformPoints(transform, corners, corners, 4);
 
-    SDL_FPoint pivot = {m_pivot.x * destRect.w, m_pivot.y * destRect.h};
-    SDL_FRect sourceRect = m_sourceRect.ToSDLFRect();
-    SDL_SetTextureColorMod(m_texture->GetSDLTexture(), m_color.r, m_color.g,
-                           m_color.b);
-    SDL_SetTextureAlphaMod(m_texture->GetSDLTexture(), m_color.a);
+    float texWidth = static_cast<float>(m_texture->GetWidth());
+    float texHeight = static_cast<float>(m_texture->GetHeight());
+    float u0 = m_sourceRect.x / texWidth;
+    float v0 = m_sourceRect.y / texHeight;
+    float u1 = (m_sourceRect.x + m_sourceRect.w) / texWidth;
+    float v1 = (m_sourceRect.y + m_sourceRect.h) / texHeight;
+    if (m_flip == Flip::Horizontal) {
+        std::swap(u0, u1);
+    } else if (m_flip == Flip::Vertical) {
+        std::swap(v0, v1);
+    }
 
-    SDL_RenderTextureRotated(renderer.GetSDLRenderer(),
-                             m_texture->GetSDLTexture(), &sourceRect, &destRect,
-                             m_rotation, &pivot, (SDL_FlipMode)m_flip);
+    SDL_FColor color = m_color.ToSDLFColor();
+    SDL_Vertex vertices[4] = {{corners[0].ToSDLPoint(), color, {u0, v0}},
+                              {corners[1].ToSDLPoint(), color, {u1, v0}},
+                              {corners[2].ToSDLPoint(), color, {u1, v1}},
+                              {corners[3].ToSDLPoint(), color, {u0, v1}}};
+    int indices[6] = {0, 1, 2, 0, 2, 3};
+    renderer.DrawGeometry(m_texture->GetSDLTexture(), vertices, 4, indices, 6);
 }
 
 void Sprite::SetTexture(std::shared_ptr<Texture> texture) {
     m_texture = texture;
+    MarkDirty();
     if (m_texture) {
         m_sourceRect = {0.0f, 0.0f, (float)m_texture->GetWidth(),
                         (float)m_texture->GetHeight()};
@@ -18,13 +18,23 @@ void TriangleShape::SetVertices(Vector2 pos1, Vector2 pos2, Vector2 pos3) {
     m_relVertex1 = pos1 - m_position;
     m_relVertex2 = pos2 - m_position;
     m_relVertex3 = pos3 - m_position;
+    MarkDirty();
+}
+
+bool TriangleShape::GetLocalBounds(Rect &bounds) const {
+    Vector2 vertices[3] = {m_relVertex1, m_relVertex2, m_relVertex3};
+    bounds = Rect::FromPoints(vertices, 3);
+    return true;
 }
 
 void TriangleShape::Render(Renderer &renderer) {
     if (!m_visible) {
         return;
     }
-    std::array<Vector2, 3> vertices = GetAbsoluteVertices();
+    Transform2D transform = renderer.GetTransform() * GetLocalTransform();
+    Vector2 vertices[3] = {transform.Apply(m_relVertex1),
+                           transform.Apply(m_relVertex2),
+                           transform.Apply(m_relVertex3)};
     renderer.SetDrawColor(m_color);
     if (m_filled) {
         SDL_Vertex drawVertices[3];
@@ -34,12 +44,12 @@ void TriangleShape::Render(Renderer &renderer) {
             drawVertices[i].color = m_color.ToSDLFColor();
             drawVertices[i].tex_coord = {0.0f, 0.0f};
         }
-        SDL_RenderGeometry(renderer.GetSDLRenderer(), nullptr, drawVertices, 3,
-                           indices, 3);
+        renderer.DrawGeometry(nullptr, drawVertices, 3, indices, 3);
     } else {
-        renderer.DrawLine(vertices[0], vertices[1]);
-        renderer.DrawLine(vertices[1], vertices[2]);
-        renderer.DrawLine(vertices[0], vertices[2]);
+        SDL_FPoint outline[4] = {
+            vertices[0].ToSDLPoint(), vertices[1].ToSDLPoint(),
+            vertices[2].ToSDLPoint(), vertices[0].ToSDLPoint()};
+        renderer.DrawLines(outline, 4);
     }
 }
 } // namespace Engine
@@ -0,0 +1,911 @@
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_stdinc.h>
+#include <algorithm>
+#include <cstring>
+#include <engine/core/resource.hpp>
+#include <engine/core/texture.hpp>
+#include <engine/render/manager.hpp>
+#include <engine/scene/scene.hpp>
+#include <engine/util/json.hpp>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace Engine {
+namespace {
+// "GESC" read as a little endian uint32
+constexpr uint32_t SCENE_MAGIC = 0x43534547;
+// 2 added layer ordering keys, 3 layer sort modes and renderable z. JSON
+// without them still loads.
+constexpr uint32_t SCENE_VERSION = 3;
+
+constexpr uint8_t LAYER_VISIBLE = 1 << 0;
+constexpr uint8_t LAYER_SCREEN_SPACE = 1 << 1;
+
+constexpr uint8_t RENDERABLE_VISIBLE = 1 << 0;
+constexpr uint8_t RENDERABLE_FILLED = 1 << 1;
+constexpr uint8_t RENDERABLE_CLOSED = 1 << 2;
+constexpr uint8_t RENDERABLE_FAST_ROTATION = 1 << 3;
+
+constexpr int32_t NO_TEXTURE = -1;
+
+struct BinaryHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t layerCount;
+    uint32_t groupCount;
+    uint32_t groupLayerCount;
+    uint32_t textureCount;
+    uint32_t renderableCount;
+    uint32_t pointCount;
+    uint32_t stringBytes;
+};
+
+// indexed by RenderableType
+constexpr const char *TYPE_NAMES[] = {"sprite",   "text",     "rectangle",
+                                      "line",     "triangle", "circle",
+                                      "polygon",  "polyline", "particles"};
+// indexed by BlendMode and Flip
+constexpr const char *BLEND_NAMES[] = {"none", "blend", "add", "multiply"};
+constexpr const char *FLIP_NAMES[] = {"none", "horizontal", "vertical"};
+// indexed by SortMode
+constexpr const char *SORT_NAMES[] = {"none", "z", "y", "texture"};
+
+template <size_t N>
+int FindName(const char *const (&names)[N], std::string_view name) {
+    for (size_t i = 0; i < N; i++) {
+        if (name == names[i]) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool IsSaved(RenderableType type) {
+    return type != RenderableType::Text && type != RenderableType::Particles;
+}
+
+// What each type's constructor sets, used when a JSON file leaves it out
+Vector2 DefaultPivot(RenderableType type) {
+    switch (type) {
+    case RenderableType::Sprite:
+    case RenderableType::Triangle:
+    case RenderableType::Circle:
+        return Vector2(0.5f, 0.5f);
+    default:
+        return Vector2(0.0f, 0.0f);
+    }
+}
+
+bool EndsWith(std::string_view text, std::string_view suffix) {
+    return text.size() >= suffix.size() &&
+           text.substr(text.size() - suffix.size()) == suffix;
+}
+
+template <typename T>
+void AppendSection(std::string &out, const std::vector<T> &section) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    out.append(reinterpret_cast<const char *>(section.data()),
+               section.size() * sizeof(T));
+}
+
+template <typename T>
+bool ReadSection(const char *&cursor, const char *end, uint32_t count,
+                 std::vector<T> &section) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    size_t bytes = static_cast<size_t>(count) * sizeof(T);
+    if (static_cast<size_t>(end - cursor) < bytes) {
+        return false;
+    }
+    section.resize(count);
+    if (bytes > 0) {
+        std::memcpy(section.data(), cursor, bytes);
+    }
+    cursor += bytes;
+    return true;
+}
+
+struct FileDeleter {
+    void operator()(void *data) const { SDL_free(data); }
+};
+using FileData = std::unique_ptr<char, FileDeleter>;
+
+bool ReadFile(std::string_view path, FileData &data, size_t &size) {
+    data.reset(
+        static_cast<char *>(SDL_LoadFile(std::string(path).c_str(), &size)));
+    return data != nullptr;
+}
+
+void WriteVector(JsonWriter &writer, const char *key, Vector2 value) {
+    writer.Key(key);
+    writer.BeginArray(true);
+    writer.Value(value.x);
+    writer.Value(value.y);
+    writer.EndArray();
+}
+
+Vector2 ReadVector(const JsonValue &value, Vector2 fallback) {
+    if (value.Size() != 2) {
+        return fallback;
+    }
+    return Vector2(value[size_t(0)].AsFloat(fallback.x),
+                   value[size_t(1)].AsFloat(fallback.y));
+}
+
+Color ReadColor(const JsonValue &value) {
+    if (value.Size() < 3) {
+        return Color::White();
+    }
+    auto channel = [&value](size_t index) {
+        int component = value[index].AsInt(255);
+        return static_cast<uint8_t>(std::clamp(component, 0, 255));
+    };
+    return Color(channel(0), channel(1), channel(2), channel(3));
+}
+} // namespace
+
+Scene::StringRef Scene::AddString(std::string_view text) {
+    StringRef ref = {static_cast<uint32_t>(m_strings.size()),
+                     static_cast<uint32_t>(text.size())};
+    m_strings.append(text);
+    return ref;
+}
+
+std::string_view Scene::GetString(StringRef ref) const {
+    return std::string_view(m_strings).substr(ref.offset, ref.length);
+}
+
+int32_t Scene::AddTexture(std::string_view path) {
+    if (path.empty()) {
+        return NO_TEXTURE;
+    }
+    // scenes use few distinct textures, a scan beats hashing every sprite
+    for (size_t i = 0; i < m_textures.size(); i++) {
+        if (GetString(m_textures[i]) == path) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    m_textures.push_back(AddString(path));
+    return static_cast<int32_t>(m_textures.size() - 1);
+}
+
+void Scene::Clear() {
+    m_layers.clear();
+    m_groups.clear();
+    m_groupLayers.clear();
+    m_textures.clear();
+    m_renderables.clear();
+    m_points.clear();
+    m_strings.clear();
+}
+
+void Scene::Capture(const RenderManager &renderManager) {
+    Clear();
+    renderManager.ForEachLayer([this, &renderManager](const Layer &layer) {
+        LayerRecord record = {};
+        record.id = layer.GetLayerId();
+        record.order = renderManager.GetLayerOrder(record.id);
+        record.name = AddString(layer.GetName());
+        record.position = layer.GetPosition();
+        record.rotation = layer.GetRotation();
+        record.scale = layer.GetScale();
+        record.opacity = layer.GetOpacity();
+        record.parallax = layer.GetParallax();
+        record.blendMode = static_cast<uint8_t>(layer.GetBlendMode());
+        record.sortMode = static_cast<uint8_t>(layer.GetSortMode());
+        record.flags = (layer.IsVisible() ? LAYER_VISIBLE : 0) |
+                       (layer.IsScreenSpace() ? LAYER_SCREEN_SPACE : 0);
+        m_layers.push_back(record);
+        layer.ForEachRenderable([this, &layer](const Renderable &renderable) {
+            CaptureRenderable(renderable, layer.GetLayerId());
+        });
+    });
+
+    // sorted so saving the same scene twice gives the same file
+    std::vector<const std::string *> groupNames;
+    for (const auto &[name, layerIds] : renderManager.GetLayerGroups()) {
+        groupNames.push_back(&name);
+    }
+    std::sort(groupNames.begin(), groupNames.end(),
+              [](const std::string *lhs, const std::string *rhs) {
+                  return *lhs < *rhs;
+              });
+    for (const std::string *name : groupNames) {
+        const std::vector<int> &layerIds =
+            renderManager.GetLayerGroups().at(*name);
+        GroupRecord record = {};
+        record.name = AddString(*name);
+        record.firstLayer = static_cast<uint32_t>(m_groupLayers.size());
+        record.layerCount = static_cast<uint32_t>(layerIds.size());
+        m_groupLayers.insert(m_groupLayers.end(), layerIds.begin(),
+                             layerIds.end());
+        m_groups.push_back(record);
+    }
+}
+
+void Scene::CaptureRenderable(const Renderable &renderable, int layerId) {
+    RenderableType type = renderable.GetType();
+    if (!IsSaved(type)) {
+        return;
+    }
+    RenderableRecord record = {};
+    record.type = static_cast<uint8_t>(type);
+    record.layerId = layerId;
+    record.name = AddString(renderable.GetName());
+    record.texture = NO_TEXTURE;
+    record.position = renderable.GetPosition();
+    record.rotation = renderable.GetRotation();
+    record.z = renderable.GetZ();
+    record.scale = renderable.GetScale();
+    record.pivot = renderable.GetPivot();
+    record.color = renderable.GetColor();
+    record.flags = (renderable.IsVisible() ? RENDERABLE_VISIBLE : 0) |
+                   (renderable.IsFastRotation() ? RENDERABLE_FAST_ROTATION : 0);
+
+    auto addPoints = [this, &record](const std::vector<Vector2> &points) {
+        record.firstPoint = static_cast<uint32_t>(m_points.size());
+        record.pointCount = static_cast<uint32_t>(points.size());
+        m_points.insert(m_points.end(), points.begin(), points.end());
+    };
+    switch (type) {
+    case RenderableType::Sprite: {
+        const Sprite &sprite = static_cast<const Sprite &>(renderable);
+        if (std::shared_ptr<Texture> texture = sprite.GetTexture()) {
+            record.texture = AddTexture(texture->GetPath());
+        }
+        Rect source = sprite.GetSourceRect();
+        record.params[0] = source.x;
+        record.params[1] = source.y;
+        record.params[2] = source.w;
+        record.params[3] = source.h;
+        record.flip = static_cast<uint8_t>(sprite.GetFlip());
+        break;
+    }
+    case RenderableType::Rectangle: {
+        const auto &rect = static_cast<const RectangleShape &>(renderable);
+        record.params[0] = rect.GetWidth();
+        record.params[1] = rect.GetHeight();
+        record.flags |= rect.IsFilled() ? RENDERABLE_FILLED : 0;
+        break;
+    }
+    case RenderableType::Line: {
+        Vector2 end =
+            static_cast<const Line &>(renderable).GetRelativeEndPoint();
+        record.params[0] = end.x;
+        record.params[1] = end.y;
+        break;
+    }
+    case RenderableType::Triangle: {
+        const auto &triangle = static_cast<const TriangleShape &>(renderable);
+        std::array<Vector2, 3> vertices = triangle.GetVertices();
+        for (size_t i = 0; i < vertices.size(); i++) {
+            record.params[i * 2] = vertices[i].x;
+            record.params[i * 2 + 1] = vertices[i].y;
+        }
+        record.flags |= triangle.IsFilled() ? RENDERABLE_FILLED : 0;
+        break;
+    }
+    case RenderableType::Circle: {
+        const auto &circle = static_cast<const CircleShape &>(renderable);
+        record.params[0] = circle.GetRadius();
+        record.flags |= circle.IsFilled() ? RENDERABLE_FILLED : 0;
+        break;
+    }
+    case RenderableType::Polygon: {
+        const auto &polygon = static_cast<const PolygonShape &>(renderable);
+        addPoints(polygon.GetPoints());
+        record.flags |= polygon.IsFilled() ? RENDERABLE_FILLED : 0;
+        break;
+    }
+    case RenderableType::Polyline: {
+        const auto &polyline = static_cast<const PolylineShape &>(renderable);
+        addPoints(polyline.GetPoints());
+        record.params[0] = polyline.GetThickness();
+        record.flags |= polyline.IsClosed() ? RENDERABLE_CLOSED : 0;
+        break;
+    }
+    default:
+        break;
+    }
+    m_renderables.push_back(record);
+}
+
+void Scene::Instantiate(RenderManager &renderManager,
+                        ResourceManager &resources) const {
+    for (const LayerRecord &record : m_layers) {
+        std::string_view name = GetString(record.name);
+        if (!name.empty()) {
+            renderManager.RegisterLayerName(record.id, name);
+        }
+        Layer &layer = renderManager.GetLayer(record.id);
+        layer.SetLayerPosition(record.position);
+        layer.SetLayerRotation(record.rotation);
+        layer.SetLayerScale(record.scale);
+        layer.SetOpacity(record.opacity);
+        layer.SetParallax(record.parallax);
+        layer.SetBlendMode(static_cast<BlendMode>(record.blendMode));
+        layer.SetSortMode(static_cast<SortMode>(record.sortMode));
+        layer.SetVisible(record.flags & LAYER_VISIBLE);
+        layer.SetScreenSpace(record.flags & LAYER_SCREEN_SPACE);
+        // last, reordering moves the layer out from under the reference
+        renderManager.SetLayerOrder(record.id, record.order);
+    }
+    for (const GroupRecord &record : m_groups) {
+        auto first = m_groupLayers.begin() + record.firstLayer;
+        renderManager.CreateLayerGroup(
+            GetString(record.name),
+            std::vector<int>(first, first + record.layerCount));
+    }
+
+    std::vector<std::shared_ptr<Texture>> textures;
+    textures.reserve(m_textures.size());
+    for (StringRef path : m_textures) {
+        std::string pathString(GetString(path));
+        resources.AddResource(pathString, ResourceType::Texture);
+        textures.push_back(resources.FindTexture(pathString));
+    }
+
+    // every pool grows once up front instead of slab by slab
+    size_t typeCounts[std::size(TYPE_NAMES)] = {};
+    for (const RenderableRecord &record : m_renderables) {
+        typeCounts[record.type]++;
+    }
+    auto reserve = [&](auto *type, RenderableType index) {
+        using T = std::remove_pointer_t<decltype(type)>;
+        size_t count = typeCounts[static_cast<size_t>(index)];
+        if (count > 0) {
+            renderManager.GetPool<T>().Reserve(count);
+        }
+    };
+    reserve(static_cast<Sprite *>(nullptr), RenderableType::Sprite);
+    reserve(static_cast<RectangleShape *>(nullptr), RenderableType::Rectangle);
+    reserve(static_cast<Line *>(nullptr), RenderableType::Line);
+    reserve(static_cast<TriangleShape *>(nullptr), RenderableType::Triangle);
+    reserve(static_cast<CircleShape *>(nullptr), RenderableType::Circle);
+    reserve(static_cast<PolygonShape *>(nullptr), RenderableType::Polygon);
+    reserve(static_cast<PolylineShape *>(nullptr), RenderableType::Polyline);
+
+    for (const RenderableRecord &record : m_renderables) {
+        const float *params = record.params;
+        bool filled = record.flags & RENDERABLE_FILLED;
+        auto points = [this, &record]() {
+            auto first = m_points.begin() + record.firstPoint;
+            return std::vector<Vector2>(first, first + record.pointCount);
+        };
+        RenderablePtr renderable;
+        switch (static_cast<RenderableType>(record.type)) {
+        case RenderableType::Sprite: {
+            std::shared_ptr<Texture> texture;
+            if (record.texture != NO_TEXTURE) {
+                texture = textures[record.texture];
+            }
+            renderable = renderManager.MakePooled<Sprite>(texture);
+            auto &sprite = static_cast<Sprite &>(*renderable);
+            // an empty source keeps the whole texture SetTexture picked
+            if (params[2] > 0.0f && params[3] > 0.0f) {
+                sprite.SetSourceRect(
+                    Rect(params[0], params[1], params[2], params[3]));
+            }
+            sprite.SetFlip(static_cast<Flip>(record.flip));
+            break;
+        }
+        case RenderableType::Rectangle:
+            renderable = renderManager.MakePooled<RectangleShape>(
+                Rect(0.0f, 0.0f, params[0], params[1]), record.color, filled);
+            break;
+        case RenderableType::Line:
+            renderable = renderManager.MakePooled<Line>(
+                Vector2(0.0f, 0.0f), Vector2(params[0], params[1]),
+                record.color);
+            break;
+        case RenderableType::Triangle:
+            renderable = renderManager.MakePooled<TriangleShape>(
+                Vector2(params[0], params[1]), Vector2(params[2], params[3]),
+                Vector2(params[4], params[5]), record.color, filled);
+            break;
+        case RenderableType::Circle:
+            renderable = renderManager.MakePooled<CircleShape>(
+                Vector2(0.0f, 0.0f), params[0], record.color, filled);
+            break;
+        case RenderableType::Polygon:
+            renderable = renderManager.MakePooled<PolygonShape>(
+                Vector2(0.0f, 0.0f), points(), record.color, filled);
+            break;
+        case RenderableType::Polyline:
+            renderable = renderManager.MakePooled<PolylineShape>(
+                Vector2(0.0f, 0.0f), points(), record.color, params[0],
+                (record.flags & RENDERABLE_CLOSED) != 0);
+            break;
+        default:
+            continue;
+        }
+        renderable->SetPosition(record.position);
+        renderable->SetRotation(record.rotation);
+        renderable->SetZ(record.z);
+        renderable->SetScale(record.scale);
+        renderable->SetPivot(record.pivot);
+        renderable->SetColor(record.color);
+        renderable->SetVisible(record.flags & RENDERABLE_VISIBLE);
+        renderable->SetFastRotation(record.flags & RENDERABLE_FAST_ROTATION);
+        renderable->SetName(GetString(record.name));
+        renderManager.AddRenderable(std::move(renderable), record.layerId);
+    }
+}
+
+bool Scene::Validate() const {
+    auto validString = [this](StringRef ref) {
+        return static_cast<uint64_t>(ref.offset) + ref.length <=
+               m_strings.size();
+    };
+    auto validSpan = [](uint32_t first, uint32_t count, size_t size) {
+        return static_cast<uint64_t>(first) + count <= size;
+    };
+    for (const LayerRecord &record : m_layers) {
+        if (!validString(record.name) ||
+            record.blendMode >= std::size(BLEND_NAMES) ||
+            record.sortMode >= std::size(SORT_NAMES)) {
+            return false;
+        }
+    }
+    for (const GroupRecord &record : m_groups) {
+        if (!validString(record.name) ||
+            !validSpan(record.firstLayer, record.layerCount,
+                       m_groupLayers.size())) {
+            return false;
+        }
+    }
+    for (StringRef path : m_textures) {
+        if (!validString(path)) {
+            return false;
+        }
+    }
+    for (const RenderableRecord &record : m_renderables) {
+        if (record.type >= std::size(TYPE_NAMES) ||
+            !IsSaved(static_cast<RenderableType>(record.type)) ||
+            record.flip >= std::size(FLIP_NAMES) ||
+            !validString(record.name) ||
+            (record.texture != NO_TEXTURE &&
+             (record.texture < 0 ||
+              static_cast<size_t>(record.texture) >= m_textures.size())) ||
+            !validSpan(record.firstPoint, record.pointCount,
+                       m_points.size())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Scene::Save(std::string_view path) const {
+    return EndsWith(path, ".json") ? SaveJson(path) : SaveBinary(path);
+}
+
+bool Scene::Load(std::string_view path) {
+    return EndsWith(path, ".json") ? LoadJson(path) : LoadBinary(path);
+}
+
+bool Scene::SaveBinary(std::string_view path) const {
+    BinaryHeader header = {};
+    header.magic = SCENE_MAGIC;
+    header.version = SCENE_VERSION;
+    header.layerCount = static_cast<uint32_t>(m_layers.size());
+    header.groupCount = static_cast<uint32_t>(m_groups.size());
+    header.groupLayerCount = static_cast<uint32_t>(m_groupLayers.size());
+    header.textureCount = static_cast<uint32_t>(m_textures.size());
+    header.renderableCount = static_cast<uint32_t>(m_renderables.size());
+    header.pointCount = static_cast<uint32_t>(m_points.size());
+    header.stringBytes = static_cast<uint32_t>(m_strings.size());
+
+    std::string data(reinterpret_cast<const char *>(&header), sizeof(header));
+    AppendSection(data, m_layers);
+    AppendSection(data, m_groups);
+    AppendSection(data, m_groupLayers);
+    AppendSection(data, m_textures);
+    AppendSection(data, m_renderables);
+    AppendSection(data, m_points);
+    data.append(m_strings);
+    return SDL_SaveFile(std::string(path).c_str(), data.data(), data.size());
+}
+
+bool Scene::LoadBinary(std::string_view path) {
+    Clear();
+    FileData data;
+    size_t size = 0;
+    if (!ReadFile(path, data, size)) {
+        return false;
+    }
+    BinaryHeader header;
+    if (size < sizeof(header)) {
+        return SDL_SetError("Scene file too short");
+    }
+    std::memcpy(&header, data.get(), sizeof(header));
+    if (header.magic != SCENE_MAGIC) {
+        return SDL_SetError("Not a scene file, or another byte order");
+    }
+    if (header.version != SCENE_VERSION) {
+        return SDL_SetError("Unsupported scene version %u",
+                            static_cast<unsigned>(header.version));
+    }
+
+    const char *cursor = data.get() + sizeof(header);
+    const char *end = data.get() + size;
+    bool ok =
+        ReadSection(cursor, end, header.layerCount, m_layers) &&
+        ReadSection(cursor, end, header.groupCount, m_groups) &&
+        ReadSection(cursor, end, header.groupLayerCount, m_groupLayers) &&
+        ReadSection(cursor, end, header.textureCount, m_textures) &&
+        ReadSection(cursor, end, header.renderableCount, m_renderables) &&
+        ReadSection(cursor, end, header.pointCount, m_points) &&
+        static_cast<size_t>(end - cursor) == header.stringBytes;
+    if (ok) {
+        m_strings.assign(cursor, header.stringBytes);
+        ok = Validate();
+    }
+    if (!ok) {
+        Clear();
+        return SDL_SetError("Corrupt scene file");
+    }
+    return true;
+}
+
+bool Scene::SaveJson(std::string_view path) const {
+    std::string text;
+    JsonWriter writer(text);
+    WriteJson(writer);
+    return SDL_SaveFile(std::string(path).c_str(), text.data(), text.size());
+}
+
+bool Scene::LoadJson(std::string_view path) {
+    Clear();
+    FileData data;
+    size_t size = 0;
+    if (!ReadFile(path, data, size)) {
+        return false;
+    }
+    JsonValue document;
+    std::string error;
+    if (!JsonValue::Parse(std::string_view(data.get(), size), document,
+                          &error)) {
+        return SDL_SetError("Scene JSON: %s", error.c_str());
+    }
+    if (!ReadJson(document) || !Validate()) {
+        Clear();
+        return false;
+    }
+    return true;
+}
+
+void Scene::WriteJson(JsonWriter &writer) const {
+    writer.BeginObject();
+    writer.Key("version");
+    writer.Value(static_cast<int>(SCENE_VERSION));
+
+    writer.Key("layers");
+    writer.BeginArray();
+    for (const LayerRecord &record : m_layers) {
+        writer.BeginObject();
+        writer.Key("id");
+        writer.Value(record.id);
+        writer.Key("order");
+        writer.Value(record.order);
+        writer.Key("name");
+        writer.Value(GetString(record.name));
+        WriteVector(writer, "position", record.position);
+        writer.Key("rotation");
+        writer.Value(record.rotation);
+        WriteVector(writer, "scale", record.scale);
+        writer.Key("opacity");
+        writer.Value(record.opacity);
+        writer.Key("blend");
+        writer.Value(BLEND_NAMES[record.blendMode]);
+        writer.Key("sort");
+        writer.Value(SORT_NAMES[record.sortMode]);
+        WriteVector(writer, "parallax", record.parallax);
+        writer.Key("visible");
+        writer.Value((record.flags & LAYER_VISIBLE) != 0);
+        writer.Key("screenSpace");
+        writer.Value((record.flags & LAYER_SCREEN_SPACE) != 0);
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.Key("groups");
+    writer.BeginArray();
+    for (const GroupRecord &record : m_groups) {
+        writer.BeginObject();
+        writer.Key("name");
+        writer.Value(GetString(record.name));
+        writer.Key("layers");
+        writer.BeginArray(true);
+        for (uint32_t i = 0; i < record.layerCount; i++) {
+            writer.Value(m_groupLayers[record.firstLayer + i]);
+        }
+        writer.EndArray();
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.Key("renderables");
+    writer.BeginArray();
+    for (const RenderableRecord &record : m_renderables) {
+        RenderableType type = static_cast<RenderableType>(record.type);
+        const float *params = record.params;
+        writer.BeginObject();
+        writer.Key("type");
+        writer.Value(TYPE_NAMES[record.type]);
+        writer.Key("layer");
+        writer.Value(record.layerId);
+        if (record.name.length > 0) {
+            writer.Key("name");
+            writer.Value(GetString(record.name));
+        }
+        WriteVector(writer, "position", record.position);
+        writer.Key("rotation");
+        writer.Value(record.rotation);
+        if (record.z != 0.0f) {
+            writer.Key("z");
+            writer.Value(record.z);
+        }
+        WriteVector(writer, "scale", record.scale);
+        WriteVector(writer, "pivot", record.pivot);
+        writer.Key("color");
+        writer.BeginArray(true);
+        writer.Value(static_cast<int>(record.color.r));
+        writer.Value(static_cast<int>(record.color.g));
+        writer.Value(static_cast<int>(record.color.b));
+        writer.Value(static_cast<int>(record.color.a));
+        writer.EndArray();
+        writer.Key("visible");
+        writer.Value((record.flags & RENDERABLE_VISIBLE) != 0);
+        if (record.flags & RENDERABLE_FAST_ROTATION) {
+            writer.Key("fastRotation");
+            writer.Value(true);
+        }
+
+        bool filled = (record.flags & RENDERABLE_FILLED) != 0;
+        auto writePoints = [&]() {
+            writer.Key("points");
+            writer.BeginArray();
+            for (uint32_t i = 0; i < record.pointCount; i++) {
+                Vector2 point = m_points[record.firstPoint + i];
+                writer.BeginArray(true);
+                writer.Value(point.x);
+                writer.Value(point.y);
+                writer.EndArray();
+            }
+            writer.EndArray();
+        };
+        switch (type) {
+        case RenderableType::Sprite:
+            writer.Key("texture");
+            writer.Value(record.texture == NO_TEXTURE
+                             ? std::string_view()
+                             : GetString(m_textures[record.texture]));
+            writer.Key("source");
+            writer.BeginArray(true);
+            for (int i = 0; i < 4; i++) {
+                writer.Value(params[i]);
+            }
+            writer.EndArray();
+            writer.Key("flip");
+            writer.Value(FLIP_NAMES[record.flip]);
+            break;
+        case RenderableType::Rectangle:
+            WriteVector(writer, "size", Vector2(params[0], params[1]));
+            writer.Key("filled");
+            writer.Value(filled);
+            break;
+        case RenderableType::Line:
+            WriteVector(writer, "end", Vector2(params[0], params[1]));
+            break;
+        case RenderableType::Triangle:
+            writer.Key("vertices");
+            writer.BeginArray(true);
+            for (int i = 0; i < 3; i++) {
+                writer.BeginArray(true);
+                writer.Value(params[i * 2]);
+                writer.Value(params[i * 2 + 1]);
+                writer.EndArray();
+            }
+            writer.EndArray();
+            writer.Key("filled");
+            writer.Value(filled);
+            break;
+        case RenderableType::Circle:
+            writer.Key("radius");
+            writer.Value(params[0]);
+            writer.Key("filled");
+            writer.Value(filled);
+            break;
+        case RenderableType::Polygon:
+            writePoints();
+            writer.Key("filled");
+            writer.Value(filled);
+            break;
+        case RenderableType::Polyline:
+            writePoints();
+            writer.Key("thickness");
+            writer.Value(params[0]);
+            writer.Key("closed");
+            writer.Value((record.flags & RENDERABLE_CLOSED) != 0);
+            break;
+        default:
+            break;
+        }
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+}
+
+bool Scene::ReadJson(const JsonValue &document) {
+    if (!document.IsObject()) {
+        return SDL_SetError("Scene JSON: expected an object");
+    }
+    int version = document["version"].AsInt(SCENE_VERSION);
+    if (version < 1 || version > static_cast<int>(SCENE_VERSION)) {
+        return SDL_SetError("Unsupported scene version %d", version);
+    }
+
+    for (const JsonValue &value : document["layers"].GetArray()) {
+        const JsonValue &id = value["id"];
+        if (id.IsNull()) {
+            return SDL_SetError("Scene JSON: layer without an id");
+        }
+        LayerRecord record = {};
+        record.id = id.AsInt();
+        record.order = value["order"].AsInt(record.id);
+        record.name = AddString(value["name"].AsString());
+        record.position = ReadVector(value["position"], Vector2(0.0f, 0.0f));
+        record.rotation = value["rotation"].AsFloat();
+        record.scale = ReadVector(value["scale"], Vector2(1.0f, 1.0f));
+        record.opacity = value["opacity"].AsFloat(1.0f);
+        record.parallax = ReadVector(value["parallax"], Vector2(1.0f, 1.0f));
+        const JsonValue &blend = value["blend"];
+        int blendMode = static_cast<int>(BlendMode::Blend);
+        if (!blend.IsNull()) {
+            blendMode = FindName(BLEND_NAMES, blend.AsString());
+        }
+        if (blendMode < 0) {
+            return SDL_SetError("Scene JSON: unknown blend mode '%s'",
+                                blend.AsString().c_str());
+        }
+        record.blendMode = static_cast<uint8_t>(blendMode);
+        const JsonValue &sort = value["sort"];
+        int sortMode = static_cast<int>(SortMode::None);
+        if (!sort.IsNull()) {
+            sortMode = FindName(SORT_NAMES, sort.AsString());
+        }
+        if (sortMode < 0) {
+            return SDL_SetError("Scene JSON: unknown sort mode '%s'",
+                                sort.AsString().c_str());
+        }
+        record.sortMode = static_cast<uint8_t>(sortMode);
+        // UI and DEBUG default to screen space, as when RenderManager
+        // creates them
+        bool screenSpace = value["screenSpace"].AsBool(
+            record.id == Layers::UI || record.id == Layers::DEBUG);
+        record.flags = (value["visible"].AsBool(true) ? LAYER_VISIBLE : 0) |
+                       (screenSpace ? LAYER_SCREEN_SPACE : 0);
+        m_layers.push_back(record);
+    }
+
+    for (const JsonValue &value : document["groups"].GetArray()) {
+        GroupRecord record = {};
+        record.name = AddString(value["name"].AsString());
+        record.firstLayer = static_cast<uint32_t>(m_groupLayers.size());
+        for (const JsonValue &layerId : value["layers"].GetArray()) {
+            m_groupLayers.push_back(layerId.AsInt());
+        }
+        record.layerCount =
+            static_cast<uint32_t>(m_groupLayers.size()) - record.firstLayer;
+        m_groups.push_back(record);
+    }
+
+    for (const JsonValue &value : document["renderables"].GetArray()) {
+        if (!ReadJsonRenderable(value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Scene::ReadJsonRenderable(const JsonValue &value) {
+    const std::string &typeName = value["type"].AsString();
+    int typeIndex = FindName(TYPE_NAMES, typeName);
+    if (typeIndex < 0 || !IsSaved(static_cast<RenderableType>(typeIndex))) {
+        return SDL_SetError("Scene JSON: unknown renderable type '%s'",
+                            typeName.c_str());
+    }
+    RenderableType type = static_cast<RenderableType>(typeIndex);
+    RenderableRecord record = {};
+    record.type = static_cast<uint8_t>(typeIndex);
+    record.layerId = value["layer"].AsInt(Layers::WORLD);
+    record.name = AddString(value["name"].AsString());
+    record.texture = NO_TEXTURE;
+    record.position = ReadVector(value["position"], Vector2(0.0f, 0.0f));
+    record.rotation = value["rotation"].AsFloat();
+    record.z = value["z"].AsFloat();
+    record.scale = ReadVector(value["scale"], Vector2(1.0f, 1.0f));
+    record.pivot = ReadVector(value["pivot"], DefaultPivot(type));
+    record.color = ReadColor(value["color"]);
+    record.flags =
+        (value["visible"].AsBool(true) ? RENDERABLE_VISIBLE : 0) |
+        (value["fastRotation"].AsBool() ? RENDERABLE_FAST_ROTATION : 0);
+
+    float *params = record.params;
+    // rectangles and polygons are filled unless told otherwise, the rest
+    // are outlines, matching their constructors
+    bool filledByDefault = type == RenderableType::Rectangle ||
+                           type == RenderableType::Polygon;
+    if (value["filled"].AsBool(filledByDefault)) {
+        record.flags |= RENDERABLE_FILLED;
+    }
+    auto readPoints = [&]() {
+        record.firstPoint = static_cast<uint32_t>(m_points.size());
+        for (const JsonValue &point : value["points"].GetArray()) {
+            m_points.push_back(ReadVector(point, Vector2(0.0f, 0.0f)));
+        }
+        record.pointCount =
+            static_cast<uint32_t>(m_points.size()) - record.firstPoint;
+    };
+    switch (type) {
+    case RenderableType::Sprite: {
+        record.texture = AddTexture(value["texture"].AsString());
+        const JsonValue &source = value["source"];
+        for (size_t i = 0; i < 4; i++) {
+            params[i] = source[i].AsFloat();
+        }
+        const JsonValue &flip = value["flip"];
+        int flipIndex = static_cast<int>(Flip::None);
+        if (!flip.IsNull()) {
+            flipIndex = FindName(FLIP_NAMES, flip.AsString());
+        }
+        if (flipIndex < 0) {
+            return SDL_SetError("Scene JSON: unknown flip '%s'",
+                                flip.AsString().c_str());
+        }
+        record.flip = static_cast<uint8_t>(flipIndex);
+        break;
+    }
+    case RenderableType::Rectangle: {
+        Vector2 size = ReadVector(value["size"], Vector2(0.0f, 0.0f));
+        params[0] = size.x;
+        params[1] = size.y;
+        break;
+    }
+    case RenderableType::Line: {
+        Vector2 end = ReadVector(value["end"], Vector2(0.0f, 0.0f));
+        params[0] = end.x;
+        params[1] = end.y;
+        break;
+    }
+    case RenderableType::Triangle: {
+        const JsonValue &vertices = value["vertices"];
+        for (size_t i = 0; i < 3; i++) {
+            Vector2 vertex = ReadVector(vertices[i], Vector2(0.0f, 0.0f));
+            params[i * 2] = vertex.x;
+            params[i * 2 + 1] = vertex.y;
+        }
+        break;
+    }
+    case RenderableType::Circle:
+        params[0] = value["radius"].AsFloat();
+        break;
+    case RenderableType::Polygon:
+        readPoints();
+        break;
+    case RenderableType::Polyline:
+        readPoints();
+        params[0] = value["thickness"].AsFloat(1.0f);
+        if (value["closed"].AsBool()) {
+            record.flags |= RENDERABLE_CLOSED;
+        }
+        break;
+    default:
+        break;
+    }
+    m_renderables.push_back(record);
+    return true;
+}
+} // namespace Engine
@@ -0,0 +1,425 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <engine/util/json.hpp>
+
+namespace Engine {
+namespace {
+const JsonValue s_null;
+// deeper documents are rejected instead of overflowing the stack
+constexpr int MAX_DEPTH = 256;
+} // namespace
+
+const JsonValue &JsonValue::operator[](size_t index) const {
+    return index < m_array.size() ? m_array[index] : s_null;
+}
+
+const JsonValue &JsonValue::operator[](std::string_view key) const {
+    for (const auto &[name, value] : m_members) {
+        if (name == key) {
+            return value;
+        }
+    }
+    return s_null;
+}
+
+class JsonParser {
+  public:
+    explicit JsonParser(std::string_view text) : m_text(text) {}
+
+    bool Parse(JsonValue &out, std::string *error) {
+        SkipWhitespace();
+        bool ok = ParseValue(out, 0);
+        SkipWhitespace();
+        if (ok && m_pos != m_text.size()) {
+            ok = Fail("trailing characters");
+        }
+        if (!ok && error != nullptr) {
+            *error = m_error + " at offset " + std::to_string(m_pos);
+        }
+        return ok;
+    }
+
+  private:
+    bool Fail(const char *message) {
+        if (m_error.empty()) {
+            m_error = message;
+        }
+        return false;
+    }
+
+    void SkipWhitespace() {
+        while (m_pos < m_text.size() &&
+               (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' ||
+                m_text[m_pos] == '\n' || m_text[m_pos] == '\r')) {
+            m_pos++;
+        }
+    }
+
+    bool Consume(std::string_view literal) {
+        if (m_text.substr(m_pos, literal.size()) != literal) {
+            return false;
+        }
+        m_pos += literal.size();
+        return true;
+    }
+
+    bool ParseValue(JsonValue &out, int depth) {
+        if (depth > MAX_DEPTH) {
+            return Fail("nesting too deep");
+        }
+        if (m_pos >= m_text.size()) {
+            return Fail("unexpected end of input");
+        }
+        char c = m_text[m_pos];
+        if (c == '{') {
+            return ParseObject(out, depth);
+        } else if (c == '[') {
+            return ParseArray(out, depth);
+        } else if (c == '"') {
+            out.m_type = JsonValue::Type::String;
+            return ParseString(out.m_string);
+        } else if (Consume("true")) {
+            out.m_type = JsonValue::Type::Bool;
+            out.m_bool = true;
+            return true;
+        } else if (Consume("false")) {
+            out.m_type = JsonValue::Type::Bool;
+            out.m_bool = false;
+            return true;
+        } else if (Consume("null")) {
+            out.m_type = JsonValue::Type::Null;
+            return true;
+        }
+        return ParseNumber(out);
+    }
+
+    bool ParseObject(JsonValue &out, int depth) {
+        out.m_type = JsonValue::Type::Object;
+        m_pos++;
+        SkipWhitespace();
+        if (Consume("}")) {
+            return true;
+        }
+        while (true) {
+            SkipWhitespace();
+            if (m_pos >= m_text.size() || m_text[m_pos] != '"') {
+                return Fail("expected a member name");
+            }
+            std::string key;
+            if (!ParseString(key)) {
+                return false;
+            }
+            SkipWhitespace();
+            if (!Consume(":")) {
+                return Fail("expected ':'");
+            }
+            SkipWhitespace();
+            out.m_members.emplace_back(std::move(key), JsonValue());
+            if (!ParseValue(out.m_members.back().second, depth + 1)) {
+                return false;
+            }
+            SkipWhitespace();
+            if (Consume("}")) {
+                return true;
+            }
+            if (!Consume(",")) {
+                return Fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    bool ParseArray(JsonValue &out, int depth) {
+        out.m_type = JsonValue::Type::Array;
+        m_pos++;
+        SkipWhitespace();
+        if (Consume("]")) {
+            return true;
+        }
+        while (true) {
+            SkipWhitespace();
+            out.m_array.emplace_back();
+            if (!ParseValue(out.m_array.back(), depth + 1)) {
+                return false;
+            }
+            SkipWhitespace();
+            if (Consume("]")) {
+                return true;
+            }
+            if (!Consume(",")) {
+                return Fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    bool ParseHex4(unsigned &out) {
+        if (m_pos + 4 > m_text.size()) {
+            return Fail("truncated \\u escape");
+        }
+        out = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = m_text[m_pos++];
+            out <<= 4;
+            if (c >= '0' && c <= '9') {
+                out |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                out |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                out |= c - 'A' + 10;
+            } else {
+                return Fail("invalid \\u escape");
+            }
+        }
+        return true;
+    }
+
+    static void AppendUtf8(std::string &out, unsigned codepoint) {
+        if (codepoint < 0x80) {
+            out += static_cast<char>(codepoint);
+        } else if (codepoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codepoint >> 6));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else if (codepoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codepoint >> 12));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codepoint >> 18));
+            out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    bool ParseString(std::string &out) {
+        m_pos++;
+        while (m_pos < m_text.size()) {
+            char c = m_text[m_pos++];
+            if (c == '"') {
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return Fail("control character in string");
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (m_pos >= m_text.size()) {
+                break;
+            }
+            char escape = m_text[m_pos++];
+            switch (escape) {
+            case '"':
+            case '\\':
+            case '/':
+                out += escape;
+                break;
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u': {
+                unsigned codepoint;
+                if (!ParseHex4(codepoint)) {
+                    return false;
+                }
+                // a high surrogate must be followed by a low one
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                    unsigned low;
+                    if (!Consume("\\u") || !ParseHex4(low) || low < 0xDC00 ||
+                        low > 0xDFFF) {
+                        return Fail("unpaired surrogate");
+                    }
+                    codepoint =
+                        0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                } else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+                    return Fail("unpaired surrogate");
+                }
+                AppendUtf8(out, codepoint);
+                break;
+            }
+            default:
+                return Fail("invalid escape");
+            }
+        }
+        return Fail("unterminated string");
+    }
+
+    bool ParseNumber(JsonValue &out) {
+        size_t start = m_pos;
+        if (m_pos < m_text.size() && m_text[m_pos] == '-') {
+            m_pos++;
+        }
+        size_t digits = m_pos;
+        while (m_pos < m_text.size() &&
+               ((m_text[m_pos] >= '0' && m_text[m_pos] <= '9') ||
+                m_text[m_pos] == '.' || m_text[m_pos] == 'e' ||
+                m_text[m_pos] == 'E' || m_text[m_pos] == '+' ||
+                m_text[m_pos] == '-')) {
+            m_pos++;
+        }
+        if (m_pos == digits || m_text[digits] < '0' || m_text[digits] > '9') {
+            m_pos = start;
+            return Fail("unexpected character");
+        }
+        // strtod needs a terminated string, numbers are short
+        char buffer[64];
+        size_t length = m_pos - start;
+        if (length >= sizeof(buffer)) {
+            return Fail("number too long");
+        }
+        m_text.copy(buffer, length, start);
+        buffer[length] = '\0';
+        char *end = nullptr;
+        double value = std::strtod(buffer, &end);
+        if (end != buffer + length) {
+            m_pos = start;
+            return Fail("invalid number");
+        }
+        out.m_type = JsonValue::Type::Number;
+        out.m_number = value;
+        return true;
+    }
+
+    std::string_view m_text;
+    size_t m_pos = 0;
+    std::string m_error;
+};
+
+bool JsonValue::Parse(std::string_view text, JsonValue &out,
+                      std::string *error) {
+    out = JsonValue();
+    return JsonParser(text).Parse(out, error);
+}
+
+void JsonWriter::NewLine(size_t depth) {
+    m_out += '\n';
+    m_out.append(depth * 2, ' ');
+}
+
+void JsonWriter::BeforeValue() {
+    if (m_afterKey) {
+        m_afterKey = false;
+        return;
+    }
+    if (m_scopes.empty()) {
+        return;
+    }
+    Scope &scope = m_scopes.back();
+    if (scope.count++ > 0) {
+        m_out += scope.inlined ? ", " : ",";
+    }
+    if (!scope.inlined) {
+        NewLine(m_scopes.size());
+    }
+}
+
+void JsonWriter::BeginObject() {
+    BeforeValue();
+    m_out += '{';
+    m_scopes.push_back({false, 0});
+}
+
+void JsonWriter::EndObject() {
+    bool empty = m_scopes.back().count == 0;
+    m_scopes.pop_back();
+    if (!empty) {
+        NewLine(m_scopes.size());
+    }
+    m_out += '}';
+    if (m_scopes.empty()) {
+        m_out += '\n';
+    }
+}
+
+void JsonWriter::BeginArray(bool inlined) {
+    BeforeValue();
+    m_out += '[';
+    // an array inside an inlined one stays inline as well
+    bool parentInlined = !m_scopes.empty() && m_scopes.back().inlined;
+    m_scopes.push_back({inlined || parentInlined, 0});
+}
+
+void JsonWriter::EndArray() {
+    Scope scope = m_scopes.back();
+    m_scopes.pop_back();
+    if (!scope.inlined && scope.count > 0) {
+        NewLine(m_scopes.size());
+    }
+    m_out += ']';
+}
+
+void JsonWriter::Key(std::string_view key) {
+    BeforeValue();
+    WriteString(key);
+    m_out += ": ";
+    m_afterKey = true;
+}
+
+void JsonWriter::Value(double value) {
+    BeforeValue();
+    if (!std::isfinite(value)) {
+        // JSON has no infinity or NaN
+        m_out += "null";
+        return;
+    }
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    m_out += buffer;
+}
+
+void JsonWriter::Value(bool value) {
+    BeforeValue();
+    m_out += value ? "true" : "false";
+}
+
+void JsonWriter::Value(std::string_view value) {
+    BeforeValue();
+    WriteString(value);
+}
+
+void JsonWriter::WriteString(std::string_view value) {
+    m_out += '"';
+    for (char c : value) {
+        switch (c) {
+        case '"':
+            m_out += "\\\"";
+            break;
+        case '\\':
+            m_out += "\\\\";
+            break;
+        case '\n':
+            m_out += "\\n";
+            break;
+        case '\r':
+            m_out += "\\r";
+            break;
+        case '\t':
+            m_out += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char escape[8];
+                std::snprintf(escape, sizeof(escape), "\\u%04x",
+                              static_cast<unsigned>(c));
+                m_out += escape;
+            } else {
+                m_out += c;
+            }
+        }
+    }
+    m_out += '"';
+}
+} // namespace Engine
@@ -0,0 +1,288 @@
+#include <engine/util/memory.hpp>
+
+#if ENGINE_TRACK_ALLOCATIONS
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#endif
+
+namespace Engine {
+MemoryStats &MemoryStats::operator+=(const MemoryStats &other) {
+    allocations += other.allocations;
+    bytes += other.bytes;
+    frees += other.frees;
+    liveBytes += other.liveBytes;
+    return *this;
+}
+
+namespace Memory {
+const char *GetTagName(MemoryTag tag) {
+    switch (tag) {
+    case MemoryTag::Untagged:
+        return "Untagged";
+    case MemoryTag::RenderManager:
+        return "RenderManager";
+    case MemoryTag::ResourceManager:
+        return "ResourceManager";
+    case MemoryTag::EventManager:
+        return "EventManager";
+    case MemoryTag::Renderer:
+        return "Renderer";
+    default:
+        return "Unknown";
+    }
+}
+
+#if ENGINE_TRACK_ALLOCATIONS
+namespace {
+constexpr size_t TAG_COUNT = static_cast<size_t>(MemoryTag::Count);
+
+// Constant initialised, so allocations made before main are counted too
+struct Counters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> frees{0};
+    std::atomic<uint64_t> freedBytes{0};
+};
+Counters s_counters[TAG_COUNT];
+thread_local MemoryTag s_currentTag = MemoryTag::Untagged;
+
+// Only touched by BeginFrame and the getters, from the main thread
+MemoryStats s_frameStart[TAG_COUNT];
+MemoryStats s_lastFrame[TAG_COUNT];
+
+size_t Index(MemoryTag tag) {
+    size_t index = static_cast<size_t>(tag);
+    return index < TAG_COUNT ? index : 0;
+}
+
+MemoryStats Subtract(const MemoryStats &a, const MemoryStats &b) {
+    MemoryStats result;
+    result.allocations = a.allocations - b.allocations;
+    result.bytes = a.bytes - b.bytes;
+    result.frees = a.frees - b.frees;
+    result.liveBytes = a.liveBytes - b.liveBytes;
+    return result;
+}
+} // namespace
+
+void BeginFrame() {
+    for (size_t i = 0; i < TAG_COUNT; i++) {
+        MemoryStats total = GetTotalStats(static_cast<MemoryTag>(i));
+        s_lastFrame[i] = Subtract(total, s_frameStart[i]);
+        s_frameStart[i] = total;
+    }
+}
+
+MemoryStats GetTotalStats(MemoryTag tag) {
+    const Counters &counters = s_counters[Index(tag)];
+    MemoryStats stats;
+    stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+    stats.bytes = counters.bytes.load(std::memory_order_relaxed);
+    stats.frees = counters.frees.load(std::memory_order_relaxed);
+    stats.liveBytes = static_cast<int64_t>(
+        stats.bytes - counters.freedBytes.load(std::memory_order_relaxed));
+    return stats;
+}
+
+MemoryStats GetLastFrameStats(MemoryTag tag) { return s_lastFrame[Index(tag)]; }
+
+MemoryStats GetLastFrameStats() {
+    MemoryStats stats;
+    for (const MemoryStats &tagStats : s_lastFrame) {
+        stats += tagStats;
+    }
+    return stats;
+}
+
+MemoryStats GetFrameStats(MemoryTag tag) {
+    return Subtract(GetTotalStats(tag), s_frameStart[Index(tag)]);
+}
+
+MemoryTag GetCurrentTag() { return s_currentTag; }
+
+void SetCurrentTag(MemoryTag tag) { s_currentTag = tag; }
+
+void RecordAllocation(MemoryTag tag, size_t bytes) {
+    Counters &counters = s_counters[Index(tag)];
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void RecordFree(MemoryTag tag, size_t bytes) {
+    Counters &counters = s_counters[Index(tag)];
+    counters.frees.fetch_add(1, std::memory_order_relaxed);
+    counters.freedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+#endif
+} // namespace Memory
+} // namespace Engine
+
+#if ENGINE_TRACK_ALLOCATIONS
+// Every block carries a header with its size and tag, so a free is charged
+// to the subsystem that made the allocation whichever scope it happens in.
+// The header keeps the block aligned for any fundamental type. Every form of
+// new and delete is replaced, so none falls through to the library's
+// untracked allocator.
+namespace {
+struct alignas(std::max_align_t) AllocationHeader {
+    size_t size;
+    Engine::MemoryTag tag;
+};
+
+// Over-aligned blocks are padded to their alignment, their header sits right
+// before the returned pointer and remembers where the block starts.
+struct AlignedHeader {
+    void *block;
+    size_t size;
+    Engine::MemoryTag tag;
+};
+
+void *Allocate(std::size_t size) {
+    Engine::MemoryTag tag = Engine::Memory::GetCurrentTag();
+    if (size > SIZE_MAX - sizeof(AllocationHeader)) {
+        return nullptr;
+    }
+    void *block = std::malloc(sizeof(AllocationHeader) + size);
+    if (block == nullptr) {
+        return nullptr;
+    }
+    AllocationHeader *header = static_cast<AllocationHeader *>(block);
+    header->size = size;
+    header->tag = tag;
+    Engine::Memory::RecordAllocation(tag, size);
+    return header + 1;
+}
+
+void Free(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    AllocationHeader *header = static_cast<AllocationHeader *>(ptr) - 1;
+    Engine::Memory::RecordFree(header->tag, header->size);
+    std::free(header);
+}
+
+void *AllocateAligned(std::size_t size, std::align_val_t align) {
+    Engine::MemoryTag tag = Engine::Memory::GetCurrentTag();
+    uintptr_t alignment = static_cast<uintptr_t>(align);
+    if (size > SIZE_MAX - sizeof(AlignedHeader) - (alignment - 1)) {
+        return nullptr;
+    }
+    void *block = std::malloc(sizeof(AlignedHeader) + alignment - 1 + size);
+    if (block == nullptr) {
+        return nullptr;
+    }
+    uintptr_t start =
+        reinterpret_cast<uintptr_t>(block) + sizeof(AlignedHeader);
+    uintptr_t aligned = (start + alignment - 1) & ~(alignment - 1);
+    AlignedHeader *header = reinterpret_cast<AlignedHeader *>(aligned) - 1;
+    header->block = block;
+    header->size = size;
+    header->tag = tag;
+    Engine::Memory::RecordAllocation(tag, size);
+    return reinterpret_cast<void *>(aligned);
+}
+
+// The throwing forms retry through the installed new-handler, as the
+// library's own operator new does, until it frees memory or gives up.
+void *AllocateOrThrow(std::size_t size) {
+    while (true) {
+        if (void *ptr = Allocate(size)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void *AllocateAlignedOrThrow(std::size_t size, std::align_val_t align) {
+    while (true) {
+        if (void *ptr = AllocateAligned(size, align)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void FreeAligned(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    AlignedHeader *header = static_cast<AlignedHeader *>(ptr) - 1;
+    Engine::Memory::RecordFree(header->tag, header->size);
+    std::free(header->block);
+}
+} // namespace
+
+void *operator new(std::size_t size) { return AllocateOrThrow(size); }
+void *operator new[](std::size_t size) { return AllocateOrThrow(size); }
+// the nothrow forms give the new-handler its chance too
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return AllocateOrThrow(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void *ptr) noexcept { Free(ptr); }
+void operator delete[](void *ptr) noexcept { Free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { Free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { Free(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { Free(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    Free(ptr);
+}
+
+void *operator new(std::size_t size, std::align_val_t align) {
+    return AllocateAlignedOrThrow(size, align);
+}
+void *operator new[](std::size_t size, std::align_val_t align) {
+    return AllocateAlignedOrThrow(size, align);
+}
+void *operator new(std::size_t size, std::align_val_t align,
+                   const std::nothrow_t &) noexcept {
+    try {
+        return AllocateAlignedOrThrow(size, align);
+    } catch (...) {
+        return nullptr;
+    }
+}
+void *operator new[](std::size_t size, std::align_val_t align,
+                     const std::nothrow_t &) noexcept {
+    return operator new(size, align, std::nothrow);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    FreeAligned(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    FreeAligned(ptr);
+}
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    FreeAligned(ptr);
+}
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+    FreeAligned(ptr);
+}
+void operator delete(void *ptr, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+    FreeAligned(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+    FreeAligned(ptr);
+}
+#endif
@@ -0,0 +1,70 @@
+#include <SDL3/SDL_timer.h>
+#include <atomic>
+#include <engine/util/startup.hpp>
+#include <mutex>
+
+namespace Engine {
+namespace Startup {
+namespace {
+std::mutex s_mutex;
+std::vector<Step> s_steps;
+std::atomic<uint64_t> s_begin{0};
+std::atomic<bool> s_firstFrameDone{false};
+double s_timeToFirstFrame = -1.0;
+
+// 0 doubles as "not started", SDL_GetTicksNS only returns it in its very
+// first nanosecond
+uint64_t BeginTicks() {
+    uint64_t begin = s_begin.load();
+    if (begin == 0) {
+        uint64_t now = SDL_GetTicksNS();
+        s_begin.compare_exchange_strong(begin, now);
+        begin = s_begin.load();
+    }
+    return begin;
+}
+
+double SinceBegin(uint64_t ticks) {
+    uint64_t begin = BeginTicks();
+    return ticks > begin ? (ticks - begin) / 1e6 : 0.0;
+}
+} // namespace
+
+void Begin() { BeginTicks(); }
+
+bool MarkFirstFrame() {
+    if (s_firstFrameDone.exchange(true)) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_timeToFirstFrame = SinceBegin(SDL_GetTicksNS());
+    return true;
+}
+
+double GetTimeToFirstFrame() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_timeToFirstFrame;
+}
+
+std::vector<Step> GetSteps() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_steps;
+}
+
+StepScope::StepScope(std::string_view name, bool mainThread)
+    : m_name(name), m_start(SDL_GetTicksNS()), m_mainThread(mainThread) {
+    BeginTicks();
+}
+
+StepScope::~StepScope() {
+    uint64_t end = SDL_GetTicksNS();
+    Step step;
+    step.name = std::move(m_name);
+    step.startMs = SinceBegin(m_start);
+    step.durationMs = (end - m_start) / 1e6;
+    step.mainThread = m_mainThread;
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_steps.push_back(std::move(step));
+}
+} // namespace Startup
+} // namespace Engine
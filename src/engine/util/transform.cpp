@@ -0,0 +1,64 @@
+#include <engine/util/transform.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENGINE_TRANSFORM_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ENGINE_TRANSFORM_NEON
+#endif
+
+namespace Engine {
+static_assert(sizeof(Vector2) == 2 * sizeof(float),
+              "TransformPoints treats Vector2 arrays as packed floats");
+
+// Points are stored interleaved (x0 y0 x1 y1 ...), so a 4-wide register holds
+// two of them. With s the same register with x and y swapped per point:
+//   result = p * (a d a d) + s * (c b c b) + (tx ty tx ty)
+void TransformPoints(const Transform2D &t, const Vector2 *in, Vector2 *out,
+                     size_t count) {
+    size_t i = 0;
+#if defined(ENGINE_TRANSFORM_SSE2)
+    const float *src = reinterpret_cast<const float *>(in);
+    float *dst = reinterpret_cast<float *>(out);
+    const __m128 ad = _mm_setr_ps(t.a, t.d, t.a, t.d);
+    const __m128 cb = _mm_setr_ps(t.c, t.b, t.c, t.b);
+    const __m128 txy = _mm_setr_ps(t.tx, t.ty, t.tx, t.ty);
+    for (; i + 4 <= count; i += 4) {
+        __m128 p01 = _mm_loadu_ps(src + 2 * i);
+        __m128 p23 = _mm_loadu_ps(src + 2 * i + 4);
+        __m128 s01 = _mm_shuffle_ps(p01, p01, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 s23 = _mm_shuffle_ps(p23, p23, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 r01 = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(p01, ad), _mm_mul_ps(s01, cb)), txy);
+        __m128 r23 = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(p23, ad), _mm_mul_ps(s23, cb)), txy);
+        _mm_storeu_ps(dst + 2 * i, r01);
+        _mm_storeu_ps(dst + 2 * i + 4, r23);
+    }
+#elif defined(ENGINE_TRANSFORM_NEON)
+    const float *src = reinterpret_cast<const float *>(in);
+    float *dst = reinterpret_cast<float *>(out);
+    const float adValues[4] = {t.a, t.d, t.a, t.d};
+    const float cbValues[4] = {t.c, t.b, t.c, t.b};
+    const float txyValues[4] = {t.tx, t.ty, t.tx, t.ty};
+    const float32x4_t ad = vld1q_f32(adValues);
+    const float32x4_t cb = vld1q_f32(cbValues);
+    const float32x4_t txy = vld1q_f32(txyValues);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t p01 = vld1q_f32(src + 2 * i);
+        float32x4_t p23 = vld1q_f32(src + 2 * i + 4);
+        float32x4_t r01 =
+            vmlaq_f32(vmlaq_f32(txy, p01, ad), vrev64q_f32(p01), cb);
+        float32x4_t r23 =
+            vmlaq_f32(vmlaq_f32(txy, p23, ad), vrev64q_f32(p23), cb);
+        vst1q_f32(dst + 2 * i, r01);
+        vst1q_f32(dst + 2 * i + 4, r23);
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = t.Apply(in[i]);
+    }
+}
+} // namespace Engine
@@ -1,25 +1,158 @@
 #include <SDL3/SDL_keycode.h>
 #include <SDL3/SDL_main.h>
+#include <SDL3/SDL_timer.h>
+#include <cstdio>
 #include <engine/engine.hpp>
 #include <engine/logger.hpp>
+#include <string_view>
+
+// Set by --memstats, draws per subsystem allocation counts every frame.
+static bool s_showMemoryStats = false;
+
+// Animation step of replays and headless runs, which must come out the same
+// on every run no matter how fast frames are produced.
+constexpr float FIXED_DT = 1.0f / 60.0f;
+
+// Shared by the SDL callbacks through appState.
+struct AppState {
+    Engine::Engine *engine = nullptr;
+    bool fixedTimestep = false;
+    // end of the previous iteration's wall clock step
+    Uint64 lastTicks = 0;
+    // whether the previous frame drew an overlay over the retained frame
+    bool hadOverlay = false;
+};
+
+// Last frame's allocations per tag and the texture cache size, top left.
+// Drawn straight through the renderer rather than DebugDraw, which compiles
+// out of the release builds these numbers matter most in.
+static void DrawMemoryStats(Engine::Engine &gameEngine) {
+    Engine::Renderer &renderer = gameEngine.GetRenderer();
+    renderer.SetDrawColor(Engine::Color::White());
+    char line[128];
+    Engine::Vector2 pos(8.0f, 8.0f);
+    for (int i = 0; i < static_cast<int>(Engine::MemoryTag::Count); i++) {
+        Engine::MemoryTag tag = static_cast<Engine::MemoryTag>(i);
+        Engine::MemoryStats frame = Engine::Memory::GetLastFrameStats(tag);
+        Engine::MemoryStats total = Engine::Memory::GetTotalStats(tag);
+        std::snprintf(line, sizeof(line),
+                      "%-16s %6llu allocs/frame %8lld KiB live",
+                      Engine::Memory::GetTagName(tag),
+                      static_cast<unsigned long long>(frame.allocations),
+                      static_cast<long long>(total.liveBytes / 1024));
+        renderer.DrawDebugText(pos, line);
+        pos.y += 10.0f;
+    }
+    const Engine::ResourceManager &resources = gameEngine.GetResources();
+    std::snprintf(line, sizeof(line), "%-16s %6zu textures %11zu KiB",
+                  "Textures", resources.GetTextureCount(),
+                  resources.GetTextureMemory() / 1024);
+    renderer.DrawDebugText(pos, line);
+}
+
+// Time to the first frame and what startup spent it on, logged once.
+static void LogStartup() {
+    SPDLOG_INFO("Startup: first frame after {:.1f} ms",
+                Engine::Startup::GetTimeToFirstFrame());
+    for (const Engine::Startup::Step &step : Engine::Startup::GetSteps()) {
+        SPDLOG_INFO("Startup: {:<18} at {:7.1f} ms took {:7.1f} ms{}",
+                    step.name, step.startMs, step.durationMs,
+                    step.mainThread ? "" : " (worker)");
+    }
+}
 
 // Initialises subsystems and initialises appState to be used by all other main
 // functions.
 SDL_AppResult SDL_AppInit(void **appState, int argc, char *argv[]) {
+    Engine::Startup::Begin();
     SPDLOG_INFO("Initializing application.");
-    Engine::Logging::Init();
+    {
+        Engine::Startup::StepScope step("logging");
+        Engine::Logging::Init();
+    }
+
+    // --record <file> logs input for later, --replay <file> plays it back
+    // instead of live input, --headless renders without a display and
+    // --damage redraws only what changed. --memstats shows allocation counts,
+    // which need the GAME_ENGINE_TRACK_ALLOCATIONS build option. --scene
+    // <file> loads a saved scene, binary or .json. --manifest <file> lists
+    // textures to decode in the background during startup.
+    Engine::WindowProps windowProps;
+    const char *recordPath = nullptr;
+    const char *replayPath = nullptr;
+    const char *scenePath = nullptr;
+    const char *manifestPath = nullptr;
+    bool damageTracking = false;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--headless") {
+            windowProps.headless = true;
+        } else if (arg == "--damage") {
+            damageTracking = true;
+        } else if (arg == "--memstats") {
+            s_showMemoryStats = true;
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (arg == "--scene" && i + 1 < argc) {
+            scenePath = argv[++i];
+        } else if (arg == "--manifest" && i + 1 < argc) {
+            manifestPath = argv[++i];
+        } else {
+            SPDLOG_WARN("Ignoring unknown argument: {}", arg);
+        }
+    }
 
     Engine::Engine *gameEngine = &Engine::Engine::Instance();
     SDL_SetAppMetadata("GameEngine", "0.0.1",
                        "org.acm.pesuecc.aiep.game-engine");
 
     SPDLOG_INFO("Initializing game engine.");
-    if (!gameEngine->Init()) {
-        SPDLOG_CRITICAL("Failed to initialize game engine.");
+    if (!gameEngine->Init(windowProps,
+                          manifestPath != nullptr ? manifestPath : "")) {
+        SPDLOG_CRITICAL("Failed to initialize game engine: {}",
+                        SDL_GetError());
         return SDL_APP_FAILURE;
     }
     SPDLOG_INFO("Game engine initialized successfully.");
 
+    if (replayPath != nullptr) {
+        SPDLOG_INFO("Replaying input from {}", replayPath);
+        if (!gameEngine->GetEvents().StartReplay(replayPath)) {
+            SPDLOG_CRITICAL("Failed to open input replay {}", replayPath);
+            return SDL_APP_FAILURE;
+        }
+    } else if (recordPath != nullptr) {
+        SPDLOG_INFO("Recording input to {}", recordPath);
+        if (!gameEngine->GetEvents().StartRecording(recordPath)) {
+            SPDLOG_ERROR("Failed to open input recording {}", recordPath);
+        }
+    }
+
+    if (s_showMemoryStats && !Engine::Memory::IsTracking()) {
+        SPDLOG_WARN("Allocation tracking is not compiled in, --memstats only "
+                    "shows texture memory.");
+    }
+
+    if (damageTracking) {
+        SPDLOG_INFO("Redrawing only changed areas.");
+        gameEngine->GetRenderManager().SetDamageTracking(true);
+    }
+
+    if (scenePath != nullptr) {
+        Engine::Scene scene;
+        if (!scene.Load(scenePath)) {
+            SPDLOG_CRITICAL("Failed to load scene {}: {}", scenePath,
+                            SDL_GetError());
+            return SDL_APP_FAILURE;
+        }
+        scene.Instantiate(gameEngine->GetRenderManager(),
+                          gameEngine->GetResources());
+        SPDLOG_INFO("Loaded {} renderables from {}",
+                    scene.GetRenderableCount(), scenePath);
+    }
+
     SPDLOG_INFO("Setting window dimensions to 1000x800.");
     gameEngine->GetWindow().SetDimensions(1000, 800);
 
@@ -59,12 +192,20 @@ SDL_AppResult SDL_AppInit(void **appState, int argc, char *argv[]) {
 
     gameEngine->GetEvents().RegisterCallback(
         Engine::EventType::MouseMove, [](Engine::EventData data) {
-            SPDLOG_INFO("Mouse moved to: ({:.0f}, {:.0f})", data.mouse.x,
-                        data.mouse.y);
+            SPDLOG_TRACE("Mouse moved to: ({:.0f}, {:.0f})", data.mouse.x,
+                         data.mouse.y);
         });
 
+    AppState *state = new AppState();
+    state->engine = gameEngine;
+    state->fixedTimestep = windowProps.headless || replayPath != nullptr;
+    state->lastTicks = SDL_GetTicksNS();
+    if (state->fixedTimestep) {
+        SPDLOG_INFO("Animating with a fixed {:.4f} s step.", FIXED_DT);
+    }
+
     SPDLOG_INFO("Application initialized successfully.");
-    *appState = gameEngine;
+    *appState = state;
     return SDL_APP_CONTINUE;
 }
 
@@ -72,7 +213,7 @@ SDL_AppResult SDL_AppInit(void **appState, int argc, char *argv[]) {
 // TODO: Try and make a genericsed function that is called from here to allow
 //       custom event handling to be added by a user.
 SDL_AppResult SDL_AppEvent(void *appState, SDL_Event *event) {
-    Engine::Engine *gameEngine = static_cast<Engine::Engine *>(appState);
+    Engine::Engine *gameEngine = static_cast<AppState *>(appState)->engine;
     if (event->type == SDL_EVENT_QUIT || event->type == SDL_EVENT_TERMINATING) {
         SPDLOG_INFO("Received SDL_EVENT_QUIT or SDL_EVENT_TERMINATING. Exiting "
                     "application.");
@@ -84,19 +225,76 @@ SDL_AppResult SDL_AppEvent(void *appState, SDL_Event *event) {
     return SDL_APP_CONTINUE;
 }
 
+// How long an iteration sleeps when damage tracking skipped the frame.
+constexpr Uint32 IDLE_FRAME_MS = 16;
+
 // The "main loop" of the window.
 SDL_AppResult SDL_AppIterate(void *appState) {
-    Engine::Engine *gameEngine = static_cast<Engine::Engine *>(appState);
+    AppState *state = static_cast<AppState *>(appState);
+    Engine::Engine *gameEngine = state->engine;
     SPDLOG_TRACE("Starting main loop iteration.");
 
-    SPDLOG_DEBUG("Clearing renderer with color: Black.");
-    gameEngine->GetRenderer().Clear(Engine::Color::Black());
+    if (gameEngine->GetEvents().IsReplayFinished()) {
+        SPDLOG_INFO("Input replay finished after {} frames. Exiting "
+                    "application.",
+                    gameEngine->GetEvents().GetFrame());
+        return SDL_APP_SUCCESS;
+    }
+
+    gameEngine->BeginFrame();
+
+    SPDLOG_DEBUG("Dispatching replayed and coalesced events.");
+    gameEngine->GetEvents().Update();
 
-    SPDLOG_DEBUG("Rendering all objects.");
-    gameEngine->GetRenderManager().RenderAll(gameEngine->GetRenderer());
+    SPDLOG_DEBUG("Updating input state.");
+    gameEngine->GetInputs().Update();
+
+    float dt = FIXED_DT;
+    if (!state->fixedTimestep) {
+        Uint64 now = SDL_GetTicksNS();
+        dt = static_cast<float>(now - state->lastTicks) / 1e9f;
+        state->lastTicks = now;
+    }
+
+    SPDLOG_DEBUG("Advancing sprite animations.");
+    gameEngine->GetAnimator().Update(dt);
+
+    Engine::Renderer &renderer = gameEngine->GetRenderer();
+    Engine::RenderManager &rdrMgr = gameEngine->GetRenderManager();
+    if (rdrMgr.IsDamageTracking()) {
+        SPDLOG_DEBUG("Redrawing damaged area.");
+        // overlays are drawn over the window every frame, so they force one,
+        // and so does the first frame without one to present it cleared
+        bool hasOverlay = s_showMemoryStats ||
+                          gameEngine->GetDebugDraw().GetUsedBytes() > 0;
+        bool force = hasOverlay || state->hadOverlay;
+        state->hadOverlay = hasOverlay;
+        if (!rdrMgr.RenderDamaged(renderer, Engine::Color::Black(), force)) {
+            SPDLOG_TRACE("Nothing changed, skipping frame.");
+            // nothing presented means no vsync wait, so idle here instead
+            SDL_Delay(IDLE_FRAME_MS);
+            return SDL_APP_CONTINUE;
+        }
+    } else {
+        SPDLOG_DEBUG("Clearing renderer with color: Black.");
+        renderer.Clear(Engine::Color::Black());
+
+        SPDLOG_DEBUG("Rendering all objects.");
+        rdrMgr.RenderAll(renderer);
+    }
+
+    SPDLOG_DEBUG("Flushing debug draw commands.");
+    gameEngine->GetDebugDraw().Flush(gameEngine->GetRenderer());
+
+    if (s_showMemoryStats) {
+        DrawMemoryStats(*gameEngine);
+    }
 
     SPDLOG_DEBUG("Presenting rendered frame.");
     gameEngine->GetRenderer().Present();
+    if (Engine::Startup::MarkFirstFrame()) {
+        LogStartup();
+    }
 
     SPDLOG_TRACE("Main loop iteration completed.");
     return SDL_APP_CONTINUE;
@@ -104,12 +302,14 @@ SDL_AppResult SDL_AppIterate(void *appState) {
 
 // Cleans up the initialised subsystems.
 void SDL_AppQuit(void *appState, SDL_AppResult result) {
-    Engine::Engine *gameEngine = static_cast<Engine::Engine *>(appState);
-    if (gameEngine != nullptr) {
+    AppState *state = static_cast<AppState *>(appState);
+    if (state != nullptr) {
         SPDLOG_INFO("Shutting down game engine.");
-        gameEngine->Shutdown();
+        state->engine->Shutdown();
         SPDLOG_INFO("Game engine shutdown completed.");
+        delete state;
     } else {
         SPDLOG_WARN("Game engine was null during shutdown.");
     }
+    Engine::Logging::Shutdown();
 }
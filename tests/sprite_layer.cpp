@@ -187,6 +187,12 @@ SDL_AppResult SDL_AppIterate(void *appState) {
     Engine::Engine *gameEngine = static_cast<Engine::Engine *>(appState);
     SPDLOG_TRACE("Starting main loop iteration.");
 
+    SPDLOG_DEBUG("Dispatching replayed and coalesced events.");
+    gameEngine->GetEvents().Update();
+
+    SPDLOG_DEBUG("Updating input state.");
+    gameEngine->GetInputs().Update();
+
     SPDLOG_DEBUG("Clearing renderer with color: Black.");
     gameEngine->GetRenderer().Clear(Engine::Color::Black());
 